@@ -126,6 +126,11 @@
 
 #define INFRA_FUNC_ATTR_INTRINSICS_AVX512_F
 
+#define INFRA_FUNC_ATTR_INTRINSICS_PCLMUL
+#define INFRA_FUNC_ATTR_INTRINSICS_VPCLMUL
+
+#define INFRA_FUNC_ATTR_INTRINSICS_BMI2
+
 #if INFRA_COMPILER_GCC || INFRA_COMPILER_CLANG
 
     #undef INFRA_FUNC_ATTR_INTRINSICS_SSE
@@ -160,4 +165,13 @@
 
     #undef INFRA_FUNC_ATTR_INTRINSICS_AVX512_F
     #define INFRA_FUNC_ATTR_INTRINSICS_AVX512_F __attribute__((target("avx512f")))
+
+    #undef INFRA_FUNC_ATTR_INTRINSICS_PCLMUL
+    #define INFRA_FUNC_ATTR_INTRINSICS_PCLMUL __attribute__((target("pclmul")))
+
+    #undef INFRA_FUNC_ATTR_INTRINSICS_VPCLMUL
+    #define INFRA_FUNC_ATTR_INTRINSICS_VPCLMUL __attribute__((target("vpclmulqdq")))
+
+    #undef INFRA_FUNC_ATTR_INTRINSICS_BMI2
+    #define INFRA_FUNC_ATTR_INTRINSICS_BMI2 __attribute__((target("bmi2")))
 #endif
@@ -18,11 +18,14 @@
 #include <array> // for crc32c table
 #include <bit> // bit_cast
 #include <limits> // is_iec559
+#include <ranges> // enable_borrowed_range
+#include <vector> // 压缩前的临时缓冲区
 
 #include "infra/common.hpp"
 #include "infra/arch.hpp"
 #include "infra/meta.hpp"
 #include "infra/attributes.hpp"
+#include "infra/assert.hpp"
 #include "infra/endian.hpp"
 
 
@@ -39,6 +42,25 @@ static_assert(CHAR_BIT == 8, "char bit MUST == 8");
 |   8    |  checksum    |    4B     | CRC32校验值  |
 |   12   |   data       |    Rest   | 实际序列化数据 |
 
+V2 (magic为"InF2"，数据超过4GB或者需要flags时使用):
+| offset |  field       | byte size | description |
+|   0    |  magic       |    4B     | 文件格式判断   |
+|   4    |  flags       |    4B     | 压缩、校验算法、分块、编码方式 |
+|   8    |  data length |    8B     | 数据长度      |
+|   16   |  checksum    |    4B     | CRC32校验值  |
+|   20   |  reserved    |    4B     | 必须为0      |
+|   24   |   data       |    Rest   | 实际序列化数据 |
+
+校验和依次计算: magic(V2还有flags)、data、data length
+
+V2分块存储(flags bit 8，SerializeOptions::chunk_size)时，数据区开头是分块表:
+|  field       | byte size  | description |
+|  chunk count |    8B      | 分块数量      |
+|  chunk table | count * 8B | 每块: length(4B) + CRC32C(4B) |
+|  payload     |    N       | 实际序列化数据，按顺序切分成若干块 |
+此时header的校验和只覆盖magic、flags、分块表(含chunk count)、data length，每块数据由自己的CRC32C校验
+分块表在数据之前，顺序读取时拿到第0块就可以开始校验和解码，不需要等到整个文件读完
+
 开发者在实际使用库的时候，建议在每一个序列化的结构体中添加以下字段:
 1. version;         (当文件字段发生变更，比如增加或删减，可以通过version来识别)
 2. type_id;         (用于判断文件所存储的对象是否是自己想要反序列化的对象)
@@ -53,6 +75,12 @@ namespace infra::binary_serialization
 
     using data_length_t = uint32_t;
 
+    enum class HeaderVersion : uint8_t
+    {
+        V1 = 1,     // 12B，数据最大4GB
+        V2 = 2,     // 24B，64位数据长度 + flags
+    };
+
     namespace detail
     {
         INFRA_BEGIN_PACKED_STRUCT(Header)
@@ -76,6 +104,67 @@ namespace infra::binary_serialization
 
         INFRA_HEADER_GLOBAL_CONSTEXPR size_t DataOffset = sizeof(Header);
         static_assert(DataOffset == 12);
+
+        INFRA_BEGIN_PACKED_STRUCT(HeaderV2)
+        {
+            uint8_t magic[4];
+            uint32_t flags;
+            uint64_t data_length;
+            crc32c_t checksum;
+            uint32_t reserved;
+        };
+        static_assert(sizeof(HeaderV2) == 24);
+        INFRA_END_PACKED_STRUCT
+
+        INFRA_HEADER_GLOBAL_CONSTEXPR uint8_t MagicValueV2[4] = { 'I', 'n', 'F', '2' };
+
+        INFRA_HEADER_GLOBAL_CONSTEXPR size_t FlagsOffsetV2 = offsetof(HeaderV2, flags);
+        INFRA_HEADER_GLOBAL_CONSTEXPR size_t FlagsSizeV2 = sizeof(uint32_t);
+
+        INFRA_HEADER_GLOBAL_CONSTEXPR size_t DataLengthOffsetV2 = offsetof(HeaderV2, data_length);
+        INFRA_HEADER_GLOBAL_CONSTEXPR size_t DataLengthSizeV2 = sizeof(uint64_t);
+
+        INFRA_HEADER_GLOBAL_CONSTEXPR size_t ChecksumOffsetV2 = offsetof(HeaderV2, checksum);
+
+        INFRA_HEADER_GLOBAL_CONSTEXPR size_t DataOffsetV2 = sizeof(HeaderV2);
+        static_assert(DataOffsetV2 == 24);
+
+        // V2 flags
+        // bit 0-3: 压缩算法 (0: 不压缩)
+        // bit 4-7: 校验算法 (0: CRC32C)
+        // bit 8  : 分块存储
+        // bit 9  : 长度前缀为varint (SerializeOptions::compact_length)
+        INFRA_HEADER_GLOBAL_CONSTEXPR uint32_t FlagCompressionMask = 0x0000000Fu;
+        INFRA_HEADER_GLOBAL_CONSTEXPR uint32_t FlagChecksumMask = 0x000000F0u;
+        INFRA_HEADER_GLOBAL_CONSTEXPR uint32_t FlagChunked = 1u << 8;
+        INFRA_HEADER_GLOBAL_CONSTEXPR uint32_t FlagCompactLength = 1u << 9;
+
+        // 当前版本能够读取的flags，其余的位不为0时拒绝读取(压缩算法还需要单独检查)
+        INFRA_HEADER_GLOBAL_CONSTEXPR uint32_t FlagsSupported = FlagCompressionMask | FlagChunked | FlagCompactLength;
+
+        // 分块表中每一项: length(4B) + CRC32C(4B)
+        INFRA_HEADER_GLOBAL_CONSTEXPR size_t ChunkEntrySize = sizeof(uint32_t) + sizeof(crc32c_t);
+        INFRA_HEADER_GLOBAL_CONSTEXPR size_t ChunkCountSize = sizeof(uint64_t);
+
+        // 两个版本的header中各个字段的位置
+        struct HeaderLayout
+        {
+            HeaderVersion version;
+            const uint8_t* magic;
+            size_t prefix_size;         // [0, prefix_size) 在数据之前计入校验和
+            size_t data_length_offset;
+            size_t data_length_size;
+            size_t data_offset;
+            uint64_t max_data_length;
+        };
+
+        INFRA_HEADER_GLOBAL_CONSTEXPR HeaderLayout HeaderV1Layout = {
+            HeaderVersion::V1, MagicValue, MagicSize, DataLengthOffset, DataLengthSize, DataOffset, UINT32_MAX
+        };
+
+        INFRA_HEADER_GLOBAL_CONSTEXPR HeaderLayout HeaderV2Layout = {
+            HeaderVersion::V2, MagicValueV2, FlagsOffsetV2 + FlagsSizeV2, DataLengthOffsetV2, DataLengthSizeV2, DataOffsetV2, UINT64_MAX
+        };
     }
 
     // checksum
@@ -90,6 +179,32 @@ namespace infra::binary_serialization
         ) noexcept;
 #endif
 
+#if INFRA_ARCH_X86_64
+        // 3路交织的crc32指令，大块数据的吞吐量接近每周期一条crc32
+        INFRA_BINARY_SERIALIZATION_API INFRA_FUNC_ATTR_INTRINSICS_SSE4_2
+        crc32c_t update_crc32c_checksum_x86_3way(
+            crc32c_t origin,
+            const uint8_t* data,
+            size_t size
+        ) noexcept;
+
+        // PCLMULQDQ折叠，每次并行处理64字节
+        INFRA_BINARY_SERIALIZATION_API INFRA_FUNC_ATTR_INTRINSICS_SSE4_2 INFRA_FUNC_ATTR_INTRINSICS_PCLMUL
+        crc32c_t update_crc32c_checksum_x86_pclmul(
+            crc32c_t origin,
+            const uint8_t* data,
+            size_t size
+        ) noexcept;
+
+        // VPCLMULQDQ + AVX-512折叠，每次并行处理256字节
+        INFRA_BINARY_SERIALIZATION_API INFRA_FUNC_ATTR_INTRINSICS_AVX512_F INFRA_FUNC_ATTR_INTRINSICS_PCLMUL INFRA_FUNC_ATTR_INTRINSICS_VPCLMUL
+        crc32c_t update_crc32c_checksum_x86_vpclmul(
+            crc32c_t origin,
+            const uint8_t* data,
+            size_t size
+        ) noexcept;
+#endif
+
 #if INFRA_ARCH_ARM
         INFRA_BINARY_SERIALIZATION_API
         crc32c_t update_crc32c_checksum_arm(
@@ -139,14 +254,111 @@ namespace infra::binary_serialization
             return origin ^ 0xffffffffu;
         }
 
+        // slice-by-N: table[k][n] 为字节n之后再跟k个0字节的crc，一次查N张表处理N个字节
+        template<size_t N>
+        consteval std::array<std::array<crc32c_t, 256>, N> make_crc32c_slice_table()
+        {
+            std::array<std::array<crc32c_t, 256>, N> table{};
+            table[0] = make_crc32c_table();
+            for (size_t k = 1; k < N; ++k)
+            {
+                for (size_t n = 0; n < 256; ++n)
+                {
+                    const crc32c_t prev = table[k - 1][n];
+                    table[k][n] = (prev >> 8) ^ table[0][prev & 0xff];
+                }
+            }
+            return table;
+        }
+
+        INFRA_HEADER_GLOBAL_CONSTEXPR auto crc32c_slice_table = make_crc32c_slice_table<16>();
+
+        INFRA_HEADER_GLOBAL crc32c_t crc32c_load_le32(const uint8_t* data) noexcept
+        {
+            uint32_t v;
+            memcpy(&v, data, sizeof(uint32_t));
+            endian::to_little(&v, sizeof(uint32_t));
+            return v;
+        }
+
+        // 每次处理Words个4字节，Words为2时即slice-by-8，为4时即slice-by-16
+        template<size_t Words>
+        INFRA_HEADER_GLOBAL crc32c_t update_crc32c_checksum_slice(
+            crc32c_t origin,
+            const uint8_t* data,
+            size_t size
+        ) noexcept
+        {
+            static_assert(Words * 4 <= crc32c_slice_table.size());
+            constexpr size_t Bytes = Words * 4;
+            const auto& t = crc32c_slice_table;
+
+            crc32c_t crc = origin ^ 0xffffffffu;
+
+            for (; size >= Bytes; data += Bytes, size -= Bytes)
+            {
+                crc32c_t next = 0;
+                for (size_t w = 0; w < Words; ++w)
+                {
+                    const crc32c_t v = crc32c_load_le32(data + w * 4) ^ (w == 0 ? crc : 0);
+                    const size_t k = Bytes - 1 - w * 4;
+                    next ^= t[k][v & 0xff] ^ t[k - 1][(v >> 8) & 0xff] ^ t[k - 2][(v >> 16) & 0xff] ^ t[k - 3][v >> 24];
+                }
+                crc = next;
+            }
+
+            for (; size > 0; ++data, --size)
+            {
+                crc = (crc >> 8) ^ t[0][(crc ^ *data) & 0xff];
+            }
+
+            return crc ^ 0xffffffffu;
+        }
+
+        INFRA_HEADER_GLOBAL crc32c_t update_crc32c_checksum_slice8(crc32c_t origin, const uint8_t* data, size_t size) noexcept
+        {
+            return update_crc32c_checksum_slice<2>(origin, data, size);
+        }
+
+        INFRA_HEADER_GLOBAL crc32c_t update_crc32c_checksum_slice16(crc32c_t origin, const uint8_t* data, size_t size) noexcept
+        {
+            return update_crc32c_checksum_slice<4>(origin, data, size);
+        }
+
         INFRA_BINARY_SERIALIZATION_API bool support_crc32_intrinsic() noexcept;
+
+        enum class Crc32cKernel : uint8_t
+        {
+            Scalar,         // 查表
+            Instruction,    // crc32指令
+            Pclmul,         // PCLMULQDQ折叠
+            Vpclmul,        // VPCLMULQDQ + AVX-512折叠
+        };
+
+        // 当前CPU可用的最快实现
+        INFRA_BINARY_SERIALIZATION_API Crc32cKernel crc32c_kernel() noexcept;
     }
     INFRA_HEADER_GLOBAL crc32c_t update_crc32c_checksum(crc32c_t origin, const uint8_t* data, size_t size) noexcept
     {
+    #if INFRA_ARCH_X86_64
+        // 折叠实现内部会把小块数据交给crc32指令
+        switch (detail::crc32c_kernel())
+        {
+        case detail::Crc32cKernel::Vpclmul:
+            return detail::update_crc32c_checksum_x86_vpclmul(origin, data, size);
+        case detail::Crc32cKernel::Pclmul:
+            return detail::update_crc32c_checksum_x86_pclmul(origin, data, size);
+        default:
+            break;
+        }
+    #endif
+
         // 统一进行cpuid检查，如果支持使用原生指令进行计算，则使用，否则使用fallback标量版本
         if (detail::support_crc32_intrinsic()) [[likely]]
         {
-        #if INFRA_ARCH_X86
+        #if INFRA_ARCH_X86_64
+            return detail::update_crc32c_checksum_x86_3way(origin, data, size);
+        #elif INFRA_ARCH_X86
             return detail::update_crc32c_checksum_x86(origin, data, size);
         #elif INFRA_ARCH_ARM
             return detail::update_crc32c_checksum_arm(origin, data, size);
@@ -154,10 +366,80 @@ namespace infra::binary_serialization
         }
         else [[unlikely]]
         {
-            return detail::update_crc32c_checksum_scalar(origin, data, size);
+            return detail::update_crc32c_checksum_slice16(origin, data, size);
+        }
+    }
+
+    namespace detail
+    {
+        // 反射表示下的 a * b mod P
+        INFRA_HEADER_GLOBAL constexpr crc32c_t crc32c_multmodp(crc32c_t a, crc32c_t b) noexcept
+        {
+            crc32c_t m = crc32c_t{ 1 } << 31;
+            crc32c_t p = 0;
+            for (;;)
+            {
+                if (a & m)
+                {
+                    p ^= b;
+                    if ((a & (m - 1)) == 0)
+                        break;
+                }
+                m >>= 1;
+                b = (b & 1) ? (b >> 1) ^ 0x82F63B78u : b >> 1;
+            }
+            return p;
+        }
+
+        // table[k] = x^(2^k) mod P
+        consteval std::array<crc32c_t, 32> make_crc32c_x2n_table()
+        {
+            std::array<crc32c_t, 32> table{};
+            crc32c_t p = crc32c_t{ 1 } << 30; // x^1
+            table[0] = p;
+            for (size_t k = 1; k < 32; ++k)
+            {
+                p = crc32c_multmodp(p, p);
+                table[k] = p;
+            }
+            return table;
+        }
+
+        INFRA_HEADER_GLOBAL_CONSTEXPR auto crc32c_x2n_table = make_crc32c_x2n_table();
+
+        // x^(n * 2^k) mod P
+        INFRA_HEADER_GLOBAL constexpr crc32c_t crc32c_x2nmodp(size_t n, unsigned k) noexcept
+        {
+            crc32c_t p = crc32c_t{ 1 } << 31; // x^0
+            while (n)
+            {
+                if (n & 1)
+                    p = crc32c_multmodp(crc32c_x2n_table[k & 31], p);
+                n >>= 1;
+                k++;
+            }
+            return p;
         }
     }
 
+    // 已知 crc_a = crc(A)、crc_b = crc(B)、len_b = |B|，求 crc(A|B)，复杂度 O(log len_b)
+    INFRA_HEADER_GLOBAL constexpr crc32c_t crc32c_combine(crc32c_t crc_a, crc32c_t crc_b, size_t len_b) noexcept
+    {
+        return detail::crc32c_multmodp(detail::crc32c_x2nmodp(len_b, 3), crc_a) ^ crc_b;
+    }
+
+    // 超过这个长度的数据，deserialize时使用多线程校验
+    INFRA_HEADER_GLOBAL_CONSTEXPR size_t ParallelChecksumThreshold = 64 * 1024 * 1024;
+
+    // 把数据切分给多个线程分别计算，再用crc32c_combine合并，结果与update_crc32c_checksum完全相同
+    // threads为0时使用std::thread::hardware_concurrency()，每个线程至少分到几MB数据，线程创建失败时由当前线程完成剩余部分
+    INFRA_BINARY_SERIALIZATION_API crc32c_t update_crc32c_checksum_parallel(
+        crc32c_t origin,
+        const uint8_t* data,
+        size_t size,
+        unsigned threads = 0
+    ) noexcept;
+
     template<typename T>
     concept is_bool = std::is_same_v<std::remove_cv_t<T>, bool>;
     
@@ -227,6 +509,225 @@ namespace infra::binary_serialization
         std::is_unsigned_v<meta::integral_underlying_type_t<T>> &&
         (sizeof(meta::integral_underlying_type_t<T>) == 1);
 
+    // 序列化后的字节数在编译期就能确定的类型，value == 0 表示变长或者未声明
+    // 只包含定长字段(is_value, bool, 定长C数组)的结构体可以特化此模板，Writer和Reader会对整个结构体只做一次边界检查
+    // 声明的字节数必须与to_bytes实际写入的字节数完全一致(Debug下会检查)，可以借助fixed_serialized_size_sum:
+    // template<> struct fixed_serialized_size<MyStruct> : fixed_serialized_size_sum<uint64_t, uint32_t, bool[4]> {};
+    template<typename T>
+    struct fixed_serialized_size : std::integral_constant<size_t, 0> {};
+
+    // 用户可以为结构体特化此模板(继承std::true_type)，Writer和Reader会用一次memcpy处理整个结构体，不再调用to_bytes/from_bytes
+    // 要求:
+    // 1. trivially copyable，所有成员都是is_value或is_value的C数组 (不能包含bool、指针、size_t等平台相关类型)
+    // 2. 没有padding: 满足std::has_unique_object_representations，或者fixed_serialized_size声明的字节数等于sizeof
+    //    (包含float/double的结构体只能使用后一种方式)
+    // 3. 如果提供了to_bytes/from_bytes，必须按声明顺序读写所有字段，这样两条路径的编码结果完全一致
+    // 编译期只能检查1中的trivially copyable和2，成员的类型无法检查(bool、指针成员同样能通过)，需要使用者保证
+    // 大端序平台上仍然使用to_bytes/from_bytes
+    template<typename T>
+    struct enable_memcpy_serialization : std::false_type {};
+
+    // 用户可以为结构体特化此模板(继承std::true_type)，结构体编码为 | 字节数(长度前缀) | to_bytes写入的数据 |
+    // 读取时from_bytes只能读取这段字节，没有读完的部分(新版本增加的字段)直接跳过，所以旧版本的程序可以读取新版本的数据;
+    // 新版本的from_bytes可以用Reader::remaining判断旧版本的数据中是否有新增的字段，不需要的结构体可以用Reader::skip_frame跳过
+    // 序列化时会额外执行一遍to_bytes来统计字节数(特化了fixed_serialized_size的结构体除外)，不能与enable_memcpy_serialization同时使用
+    template<typename T>
+    struct enable_framed_serialization : std::false_type {};
+
+    namespace detail
+    {
+        template<typename T>
+        consteval size_t fixed_serialized_size_impl()
+        {
+            if constexpr (is_bool<T>)
+            {
+                return sizeof(uint8_t);
+            }
+            else if constexpr (is_value<T>)
+            {
+                return sizeof(T);
+            }
+            else if constexpr (std::is_array_v<T> && std::extent_v<T> != 0)
+            {
+                return fixed_serialized_size_impl<std::remove_cv_t<std::remove_extent_t<T>>>() * std::extent_v<T>;
+            }
+            else if constexpr (enable_framed_serialization<T>::value)
+            {
+                // 长度前缀可能是varint
+                return 0;
+            }
+            else if constexpr (fixed_serialized_size<T>::value == 0 && enable_memcpy_serialization<T>::value)
+            {
+                return sizeof(T);
+            }
+            else
+            {
+                return fixed_serialized_size<T>::value;
+            }
+        }
+
+        template<typename T>
+        consteval bool check_memcpy_structure()
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "memcpy serialization requires a trivially copyable type.");
+            static_assert(std::has_unique_object_representations_v<T> || fixed_serialized_size<T>::value == sizeof(T),
+                "memcpy serialization requires a type without padding.");
+            static_assert(!enable_framed_serialization<T>::value, "memcpy serialization can not be combined with framed serialization.");
+            return true;
+        }
+    }
+
+    template<typename T>
+    INFRA_HEADER_GLOBAL_CONSTEXPR size_t fixed_serialized_size_v = detail::fixed_serialized_size_impl<std::remove_cv_t<T>>();
+
+    // 一个T序列化后至少包含的长度前缀个数(容器、framed结构体等)
+    // 长度前缀的字节数取决于编码方式(varint至少1字节，否则8字节)，由Reader::check_length按当前的编码方式计算
+    template<typename T>
+    struct length_prefix_count : std::integral_constant<size_t, enable_framed_serialization<T>::value ? 1 : 0> {};
+
+    template<typename T>
+    INFRA_HEADER_GLOBAL_CONSTEXPR size_t length_prefix_count_v = length_prefix_count<std::remove_cv_t<T>>::value;
+
+    // 一个T序列化后除长度前缀之外至少占用的字节数，反序列化容器时用来在分配内存之前检查长度前缀是否可信
+    // 默认: 定长类型为fixed_serialized_size_v，其余为0(用户结构体的to_bytes可能什么都不写，比如空的标记结构体)
+    // 确定至少占用若干字节的类型可以特化(比如Varint为1字节)
+    template<typename T>
+    struct min_serialized_size : std::integral_constant<size_t, fixed_serialized_size_v<T>> {};
+
+    template<typename T>
+    INFRA_HEADER_GLOBAL_CONSTEXPR size_t min_serialized_size_v = min_serialized_size<std::remove_cv_t<T>>::value;
+
+    template<typename T>
+    concept is_memcpy_structure =
+        is_structure<T> &&
+        enable_memcpy_serialization<std::remove_cv_t<T>>::value &&
+        detail::check_memcpy_structure<std::remove_cv_t<T>>();
+
+    template<typename T>
+    concept is_framed_structure =
+        is_structure<T> &&
+        enable_framed_serialization<std::remove_cv_t<T>>::value;
+
+    // 在内存中连续存储时可以整块拷贝的类型
+    template<typename T>
+    concept is_bulk_serializable = is_value<T> || is_memcpy_structure<T>;
+
+    // 反序列化后仍然引用源缓冲区的类型(std::basic_string_view、std::span<const T>等零拷贝视图)
+    // 这类对象不能从临时容器反序列化；包含视图成员的结构体和容器应特化此模板(继承std::true_type)
+    template<typename T>
+    struct holds_buffer_view : std::false_type {};
+
+    template<typename T>
+    INFRA_HEADER_GLOBAL_CONSTEXPR bool holds_buffer_view_v = holds_buffer_view<std::remove_cv_t<T>>::value;
+
+    // 所有字段都是定长时，结果为字段字节数之和，否则为0
+    template<typename... Fields>
+    struct fixed_serialized_size_sum : std::integral_constant<size_t,
+        ((fixed_serialized_size_v<Fields> != 0) && ...) ? (fixed_serialized_size_v<Fields> + ...) : 0> {};
+
+    namespace detail
+    {
+        // LEB128: 每字节低7位为数据，最高位为1表示后面还有字节; uint64_t最多10字节
+        INFRA_HEADER_GLOBAL_CONSTEXPR size_t MaxVarintSize = 10;
+
+        // zigzag: 绝对值小的有符号数映射为小的无符号数 (0, -1, 1, -2 ... -> 0, 1, 2, 3 ...)
+        INFRA_HEADER_GLOBAL constexpr uint64_t zigzag_encode(int64_t v) noexcept
+        {
+            return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+        }
+
+        INFRA_HEADER_GLOBAL constexpr int64_t zigzag_decode(uint64_t v) noexcept
+        {
+            return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+        }
+
+        // dst至少要有MaxVarintSize字节，返回写入的字节数
+        INFRA_HEADER_GLOBAL constexpr size_t encode_varint(uint64_t v, uint8_t* dst) noexcept
+        {
+            size_t n = 0;
+            while (v >= 0x80)
+            {
+                dst[n++] = static_cast<uint8_t>(v | 0x80);
+                v >>= 7;
+            }
+            dst[n++] = static_cast<uint8_t>(v);
+            return n;
+        }
+
+        INFRA_HEADER_GLOBAL constexpr size_t varint_size(uint64_t v) noexcept
+        {
+            size_t n = 1;
+            while (v >= 0x80)
+            {
+                v >>= 7;
+                ++n;
+            }
+            return n;
+        }
+
+        // 返回读取的字节数; 数据不完整、超过10字节或者超出uint64_t范围时返回0
+        INFRA_HEADER_GLOBAL constexpr size_t decode_varint_scalar(const uint8_t* src, size_t available, uint64_t& out) noexcept
+        {
+            const size_t limit = available < MaxVarintSize ? available : MaxVarintSize;
+
+            uint64_t v = 0;
+            for (size_t i = 0; i < limit; ++i)
+            {
+                const uint8_t byte = src[i];
+                if (i == MaxVarintSize - 1 && byte > 1)
+                    return 0;
+
+                v |= static_cast<uint64_t>(byte & 0x7f) << (7 * i);
+                if (byte < 0x80)
+                {
+                    out = v;
+                    return i + 1;
+                }
+            }
+            return 0;
+        }
+
+        // BMI2 pext一次处理8字节，要求available >= 8
+        INFRA_BINARY_SERIALIZATION_API size_t decode_varint_bmi2(const uint8_t* src, size_t available, uint64_t& out) noexcept;
+
+        // pext在Zen3之前的AMD CPU上是微码实现，比标量版本还慢，这些CPU上返回false
+        INFRA_BINARY_SERIALIZATION_API bool support_fast_pext() noexcept;
+
+        INFRA_HEADER_GLOBAL size_t decode_varint(const uint8_t* src, size_t available, uint64_t& out) noexcept
+        {
+            // 最常见的单字节
+            if (available > 0 && src[0] < 0x80) [[likely]]
+            {
+                out = src[0];
+                return 1;
+            }
+
+        #if INFRA_ARCH_X86_64
+            if (available >= 8 && support_fast_pext())
+            {
+                return decode_varint_bmi2(src, available, out);
+            }
+        #endif
+
+            return decode_varint_scalar(src, available, out);
+        }
+    }
+
+    namespace detail
+    {
+        // LZ4 block格式，与lz4库的LZ4_compress_default/LZ4_decompress_safe互相兼容
+        INFRA_HEADER_GLOBAL constexpr size_t lz4_compress_bound(size_t size) noexcept
+        {
+            return size + size / 255 + 16;
+        }
+
+        // 返回压缩后的字节数，dst的容量不足时返回0; capacity >= lz4_compress_bound(size)时一定成功
+        INFRA_BINARY_SERIALIZATION_API size_t lz4_compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity) noexcept;
+
+        // 解压出的字节数必须正好是dst_size，数据损坏时返回false，不会越界读写
+        INFRA_BINARY_SERIALIZATION_API bool lz4_decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t dst_size) noexcept;
+    }
+
     enum class ResultCode
     {
         OK = 0,                             // 无错误
@@ -236,13 +737,26 @@ namespace infra::binary_serialization
         ByteContainerTooSmall,              // byte_container的容量比文件要小，或者是文件的data_length字段出现错误
         MagicNumberIncorrect,               // magic number 错误
         ChecksumIncorrect,                  // CRC32C校验失败
-        UserAbort                           // 用户手动终止序列化或反序列化
+        UserAbort,                          // 用户手动终止序列化或反序列化
+        StreamWriteFailed,                  // 流式输出时写入文件或回填header失败
+        DataTooLarge,                       // 数据长度超过了header中data_length字段能表示的范围
+        UnalignedView,                      // 零拷贝视图的数据没有按元素类型对齐(或者主机不是小端序)，无法直接引用
+        LengthExceedsData,                  // 容器的长度前缀超过了剩余数据能容纳的元素个数
+        InvalidVarint,                      // varint超过10字节，或者解码出的值超出了目标类型的范围
+        UnsupportedHeader,                  // header中有当前版本不支持的flags，或者reserved字段不为0
+        DecompressionFailed,                // 压缩数据损坏; 或者对象包含零拷贝视图(视图不能指向解压用的临时缓冲区)
+        InvalidChunkTable,                  // 分块表中各块的长度之和与数据区不一致
+        InvalidIndex                        // 随机访问的下标越界，或者索引中的偏移不在数据范围内
     };
 
     struct Result
     {
         ResultCode code = ResultCode::OK;
 
+        // 成功时: serialize写入的字节数，deserialize消费的字节数(都包含header)
+        // 容器中连续存放多个对象时，可以用它定位下一个对象
+        size_t bytes = 0;
+
         explicit operator bool() const noexcept
         {
             return code == ResultCode::OK;
@@ -262,70 +776,505 @@ namespace infra::binary_serialization
     // static  const        ByteType*    data(const ByteContainer& container)
     // static               void         resize(ByteContainer& vec, size_t new_size)
     // static               void         push_back(ByteContainer& vec, const ByteType& val)
+    // static               size_t       capacity(const ByteContainer& vec) - (不需要重新分配内存即可容纳的字节数)
+    // static               void         reserve(ByteContainer& vec, size_t new_capacity) - (只预留内存，不改变size)
     // static  constexpr    bool         resizeable() - (类似于std::array的容器，返回false，类似于std::vector的容器，返回true)
+    //
+    // 流式输出的容器(sink)还需要实现以下接口，此时size/data/resize作用于内部的缓冲区，capacity为每次输出的块大小:
+    // static  constexpr    bool         streaming() - (返回true)
+    // static               bool         write(Sink& sink, const uint8_t* data, size_t size) - (把缓冲区的数据追加输出)
+    // static               bool         patch(Sink& sink, size_t offset, const uint8_t* data, size_t size) - (覆盖已输出的数据，用于回填header)
+    // static               size_t       written(const Sink& sink) - (已经输出的字节数，也是patch的offset基准)
     template<typename ByteContainer>
     struct Adaptor;
 
-    template<typename ByteContainer, typename Object>
-    void to_bytes(Writer<ByteContainer>& writer, const Object& object);
+    // 只统计字节数、不写入任何数据的"容器"，Writer<SizeCounter>会完整执行一遍用户的to_bytes
+    struct SizeCounter {};
 
-    template<typename ByteContainer, typename Object>
-    void from_bytes(Reader<ByteContainer>& reader, Object& object);
+    namespace detail
+    {
+        // 压缩前编码、解压后读取用的临时缓冲区
+        struct ScratchBuffer
+        {
+            std::vector<uint8_t> bytes;
+        };
+    }
 
-    template<typename ByteContainer>
-    class Writer
+    template<>
+    struct Adaptor<detail::ScratchBuffer>
     {
-        template<typename ByteContainer2, typename Object>
-        friend Result serialize(ByteContainer2&, const Object&);
+        using byte_type = uint8_t;
 
-    private:
-        ByteContainer& m_arr;
-        size_t m_pos = 0;
-        crc32c_t m_crc32c_checksum = Initial_CRC32C;
-        ResultCode m_result = ResultCode::OK;
+        static constexpr bool resizeable() noexcept
+        {
+            return true;
+        }
 
-        void auto_resize(size_t new_size) noexcept
+        static size_t size(const detail::ScratchBuffer& buffer) noexcept
         {
-            using adaptor_t = Adaptor<ByteContainer>;
+            return buffer.bytes.size();
+        }
 
-            if constexpr (adaptor_t::resizeable())
-            {
-                while (m_pos + new_size > adaptor_t::size(m_arr))
-                {
-                    adaptor_t::push_back(m_arr, std::bit_cast<typename adaptor_t::byte_type>(static_cast<uint8_t>(0)));
-                }
-            }
+        static uint8_t* data(detail::ScratchBuffer& buffer) noexcept
+        {
+            return buffer.bytes.data();
         }
 
-        void jump(size_t offset) noexcept
+        static const uint8_t* data(const detail::ScratchBuffer& buffer) noexcept
         {
-            m_pos = offset;
+            return buffer.bytes.data();
         }
 
-        template<size_t Bytes>
-        void value_impl(const void* src) noexcept
+        static void resize(detail::ScratchBuffer& buffer, size_t new_size) noexcept
         {
-            // fail-fast
-            if (m_result != ResultCode::OK)
-                return;
+            buffer.bytes.resize(new_size);
+        }
 
-            using adaptor_t = Adaptor<ByteContainer>;
+        static void push_back(detail::ScratchBuffer& buffer, const uint8_t& val) noexcept
+        {
+            buffer.bytes.push_back(val);
+        }
+
+        static size_t capacity(const detail::ScratchBuffer& buffer) noexcept
+        {
+            return buffer.bytes.capacity();
+        }
+
+        static void reserve(detail::ScratchBuffer& buffer, size_t new_capacity) noexcept
+        {
+            buffer.bytes.reserve(new_capacity);
+        }
+    };
+
+    namespace detail
+    {
+        // 数据区中的一段字节，只用于Reader(deserialize_range)
+        struct ByteRange
+        {
+            const uint8_t* data;
+            size_t size;
+        };
+    }
+
+    template<>
+    struct Adaptor<detail::ByteRange>
+    {
+        using byte_type = uint8_t;
+
+        static constexpr bool resizeable() noexcept
+        {
+            return false;
+        }
+
+        static size_t size(const detail::ByteRange& range) noexcept
+        {
+            return range.size;
+        }
+
+        static const uint8_t* data(const detail::ByteRange& range) noexcept
+        {
+            return range.data;
+        }
+    };
+
+    namespace detail
+    {
+        template<typename ByteContainer>
+        concept is_streaming_container =
+            !std::is_same_v<ByteContainer, SizeCounter> &&
+            requires { requires Adaptor<ByteContainer>::streaming(); };
+    }
+
+    enum class Compression : uint8_t
+    {
+        None = 0,
+        Lz4 = 1,    // LZ4 block格式，速度接近memcpy，适合I/O是瓶颈的场景
+    };
+
+    struct SerializeOptions
+    {
+        // 预计的序列化总字节数(含header)，可变长容器会在写入前一次性reserve，0表示不预留
+        size_t size_hint = 0;
+
+        // 先用Writer<SizeCounter>统计精确的字节数，再一次性分配输出容器 (会多执行一遍to_bytes)
+        bool exact_size = false;
+
+        // 写入数据的同时按块增量计算校验和，趁数据还在cache中，省掉结束后对整个数据区的第二遍读取
+        bool fused_checksum = false;
+
+        // 容器的长度前缀使用varint(小的长度只占1字节)，而不是定长的uint64_t
+        // 记录在header的flags中，会自动使用V2 header
+        bool compact_length = false;
+
+        // V1只能存储4GB以内的数据，超过时返回DataTooLarge；旧版本的库读取V2数据会返回MagicNumberIncorrect
+        HeaderVersion header_version = HeaderVersion::V1;
+
+        // 先把对象完整编码到临时缓冲区，再压缩后写入数据区，校验和按压缩后的字节计算
+        // 记录在header的flags中，会自动使用V2 header；压缩的数据不能反序列化为零拷贝视图
+        Compression compression = Compression::None;
+
+        // 大于0时把数据区(压缩时为压缩后的字节)每chunk_size字节分为一块，每块单独计算CRC32C，分块表写在数据区开头
+        // 分块数量需要预先确定，不压缩时会额外执行一遍to_bytes统计数据区的字节数
+        // 读取时各块可以并行校验，verify_chunks能定位损坏的块；记录在header的flags中，会自动使用V2 header
+        uint32_t chunk_size = 0;
+    };
+
+    struct DeserializeOptions
+    {
+        // 读取数据的同时按块增量校验，数据只读取一遍
+        // 注意: 校验和在对象读取完成之后才能确定，校验失败时对象中可能已经填入了部分错误数据，
+        //      损坏的长度前缀也会在校验之前被使用
+        // 分块存储的数据不使用这个选项: 所有的块总是在读取之前并行校验
+        bool fused_checksum = false;
+    };
+
+    namespace detail
+    {
+        // 增量计算校验和时每块的字节数，需要小于L1/L2 cache
+        INFRA_HEADER_GLOBAL_CONSTEXPR size_t FusedChecksumChunkSize = 16 * 1024;
+
+        // 分块表解析出的一块数据
+        struct ChunkInfo
+        {
+            const uint8_t* data;
+            size_t size;
+            crc32c_t checksum;
+        };
+
+        // 校验每一块，corrupt[i]为1表示第i块损坏
+        // threads为0时使用std::thread::hardware_concurrency()，数据量较小时只使用当前线程
+        INFRA_BINARY_SERIALIZATION_API void check_chunks(
+            const ChunkInfo* chunks,
+            size_t count,
+            uint8_t* corrupt,
+            unsigned threads = 0
+        ) noexcept;
+    }
+
+    template<typename ByteContainer, typename Object>
+    void to_bytes(Writer<ByteContainer>& writer, const Object& object);
+
+    template<typename ByteContainer, typename Object>
+    void from_bytes(Reader<ByteContainer>& reader, Object& object);
+
+    template<typename ByteContainer, typename Object>
+    Result serialize(ByteContainer& byte_array, const Object& object, const SerializeOptions& options = {});
+
+    // options中只有影响编码的选项(compact_length, compression, chunk_size)会被使用
+    template<typename Object>
+    Result serialized_size(const Object& object, size_t& out_size, const SerializeOptions& options = {});
+
+    namespace detail
+    {
+        template<typename Sink, typename Object>
+        Result serialize_to_stream(Sink& sink, const Object& object, const SerializeOptions& options);
+
+        // object编码后数据区的字节数(不含header和分块表)，不写入任何数据
+        template<typename Object>
+        ResultCode measure_payload(const Object& object, const SerializeOptions& options, size_t& out_size);
+    }
+
+    template<typename ByteContainer, typename Object>
+    Result deserialize(const ByteContainer& byte_array, Object& object, const DeserializeOptions& options = {});
+
+    // 只校验分块存储(SerializeOptions::chunk_size)的数据，不反序列化，损坏的块序号按顺序写入corrupt_chunks
+    // 有损坏的块时返回ChecksumIncorrect; 分块表本身损坏时无法定位，corrupt_chunks为空; 不是分块存储时返回UnsupportedHeader
+    template<typename ByteContainer>
+    Result verify_chunks(const ByteContainer& byte_array, std::vector<size_t>& corrupt_chunks, unsigned threads = 0);
+
+    // 从一段不带header的数据中读取object，用于延迟解码、随机访问等只记录了字节范围的场景
+    // compact_length必须与写入时一致(Reader::compact_length)；数据没有被恰好完整消费时返回IncompleteSerialization
+    template<typename Object>
+    ResultCode deserialize_range(const uint8_t* data, size_t size, Object& object, bool compact_length) noexcept;
+
+    // 视图会指向已经销毁的临时容器，禁止; std::span这类不持有内存的容器除外
+    template<typename ByteContainer, typename Object>
+        requires (!std::is_lvalue_reference_v<ByteContainer> &&
+            !std::ranges::enable_borrowed_range<std::remove_cv_t<ByteContainer>> &&
+            holds_buffer_view_v<Object>)
+    Result deserialize(ByteContainer&& byte_array, Object& object, const DeserializeOptions& options = {}) = delete;
+
+    template<typename ByteContainer>
+    class Writer
+    {
+        template<typename ByteContainer2, typename Object>
+        friend Result serialize(ByteContainer2&, const Object&, const SerializeOptions&);
+
+        template<typename Object>
+        friend Result serialized_size(const Object&, size_t&, const SerializeOptions&);
+
+        template<typename Sink, typename Object>
+        friend Result detail::serialize_to_stream(Sink&, const Object&, const SerializeOptions&);
+
+        template<typename Object>
+        friend ResultCode detail::measure_payload(const Object&, const SerializeOptions&, size_t&);
+
+        template<typename ByteContainer2>
+        friend class Writer;
+
+        // 计数模式: 只移动m_pos，不访问容器
+        static constexpr bool Counting = std::is_same_v<ByteContainer, SizeCounter>;
+
+        // 流式模式: m_pos是缓冲区内的位置，缓冲区写满时整块输出到sink
+        static constexpr bool Streaming = detail::is_streaming_container<ByteContainer>;
+
+    private:
+        ByteContainer& m_arr;
+        size_t m_pos = 0;
+        crc32c_t m_crc32c_checksum = Initial_CRC32C;
+        ResultCode m_result = ResultCode::OK;
+
+        // [0, m_checked_end) 已确认在容器内，可以跳过边界检查直接写入
+        // 出错时清零，保证之后的写入全部走慢路径(fail-fast)
+        size_t m_checked_end = 0;
+
+        // 增量校验: [m_crc_pos, m_pos) 还没有计入校验和，m_pos到达m_crc_limit时计入
+        // 不开启时m_crc_limit为SIZE_MAX
+        size_t m_crc_pos = 0;
+        size_t m_crc_limit = SIZE_MAX;
+
+        // 流式模式下已经输出到sink的字节数
+        size_t m_flushed = 0;
+
+        // 容器长度前缀使用varint
+        bool m_compact_length = false;
+
+        // 分块模式: 数据区每m_chunk_size字节单独计算一个CRC32C，0表示不分块
+        // m_chunk_filled为当前块已经计入的字节数
+        size_t m_chunk_size = 0;
+        size_t m_chunk_filled = 0;
+        crc32c_t m_chunk_checksum = Initial_CRC32C;
+        std::vector<crc32c_t> m_chunk_checksums{};
+
+        void fail(ResultCode code) noexcept
+        {
+            m_result = code;
+            m_checked_end = 0;
+        }
+
+        // 快速路径不能越过m_crc_limit，这样只需要在慢路径中检查是否该计算校验和
+        [[nodiscard]] size_t checked_end_limit(size_t size) const noexcept
+        {
+            return size < m_crc_limit ? size : m_crc_limit;
+        }
+
+        // 容量不足时按几何级数扩容，保证逐字段写入的总开销是均摊O(1)的
+        static constexpr size_t MinGrowBytes = 256;
+
+        void auto_resize(size_t new_size) noexcept
+        {
+            using adaptor_t = Adaptor<ByteContainer>;
+
+            if constexpr (Counting)
+            {
+                (void)new_size;
+            }
+            else if constexpr (Streaming)
+            {
+                // 放不下时先把缓冲区输出，缓冲区只有在单个值超过块大小时才会变大
+                if (m_pos + new_size > adaptor_t::capacity(m_arr) && m_pos > 0)
+                {
+                    flush_stream();
+                }
+
+                const size_t required = m_pos + new_size;
+                if (required > adaptor_t::size(m_arr))
+                {
+                    adaptor_t::resize(m_arr, required);
+                }
+            }
+            else if constexpr (adaptor_t::resizeable())
+            {
+                const size_t required = m_pos + new_size;
+                if (required <= adaptor_t::size(m_arr))
+                {
+                    return;
+                }
+
+                const size_t capacity = adaptor_t::capacity(m_arr);
+                if (required > capacity)
+                {
+                    size_t new_capacity = capacity * 2;
+                    if (new_capacity < MinGrowBytes)
+                        new_capacity = MinGrowBytes;
+                    if (new_capacity < required)
+                        new_capacity = required;
+
+                    adaptor_t::reserve(m_arr, new_capacity);
+                }
 
-            auto_resize(Bytes);
-            if (m_pos + Bytes > adaptor_t::size(m_arr))
+                adaptor_t::resize(m_arr, required);
+            }
+        }
+
+        void jump(size_t offset) noexcept
+        {
+            m_pos = offset;
+        }
+
+        template<size_t Bytes>
+        void value_impl(const void* src) noexcept
+        {
+            if constexpr (!Counting)
             {
-                // 序列化不完整，只序列化了对象的部分字段
-                m_result = ResultCode::IncompleteSerialization;
+                // 已经检查过的区域: 只需要一次比较
+                if (m_pos + Bytes <= m_checked_end) [[likely]]
+                {
+                    void* dst = Adaptor<ByteContainer>::data(m_arr) + m_pos;
+                    memcpy(dst, src, Bytes);
+                    endian::to_little(dst, Bytes);
+
+                    jump(m_pos + Bytes);
+                    return;
+                }
+            }
+
+            // fail-fast
+            if (m_result != ResultCode::OK)
                 return;
+
+            if constexpr (Counting)
+            {
+                (void)src;
             }
+            else
+            {
+                using adaptor_t = Adaptor<ByteContainer>;
 
-            void* dst = adaptor_t::data(m_arr) + m_pos;
-            memcpy(dst, src, Bytes);
-            endian::to_little(dst, Bytes);
+                auto_resize(Bytes);
+                if (m_pos + Bytes > adaptor_t::size(m_arr))
+                {
+                    // 序列化不完整，只序列化了对象的部分字段
+                    fail(ResultCode::IncompleteSerialization);
+                    return;
+                }
+
+                void* dst = adaptor_t::data(m_arr) + m_pos;
+                memcpy(dst, src, Bytes);
+                endian::to_little(dst, Bytes);
+
+                jump(m_pos + Bytes);
+                if (m_pos >= m_crc_limit) [[unlikely]]
+                    flush_checksum();
+                return;
+            }
 
             jump(m_pos + Bytes);
         }
 
+        // 连续count个宽度为ElemBytes的数值，整体只做一次边界检查和一次memcpy
+        template<size_t ElemBytes>
+        void values_impl(const void* src, size_t count) noexcept
+        {
+            // fail-fast
+            if (m_result != ResultCode::OK)
+                return;
+
+            const size_t bytes = ElemBytes * count;
+            if (bytes == 0)
+                return;
+
+            if constexpr (Counting)
+            {
+                (void)src;
+            }
+            else if constexpr (Streaming)
+            {
+                // 分段经过缓冲区输出，内存占用不超过块大小
+                using adaptor_t = Adaptor<ByteContainer>;
+
+                const auto* elems = static_cast<const uint8_t*>(src);
+                const size_t chunk_size = adaptor_t::capacity(m_arr);
+                while (count > 0 && m_result == ResultCode::OK)
+                {
+                    size_t n = (chunk_size > m_pos ? chunk_size - m_pos : 0) / ElemBytes;
+                    if (n == 0 && m_pos > 0)
+                    {
+                        flush_stream();
+                        continue;
+                    }
+                    n = n == 0 ? 1 : (n < count ? n : count);
+
+                    auto_resize(n * ElemBytes);
+                    auto* dst = std::bit_cast<uint8_t*>(adaptor_t::data(m_arr) + m_pos);
+                    memcpy(dst, elems, n * ElemBytes);
+                    if constexpr (endian::Current != endian::Endian::Little && ElemBytes > 1)
+                    {
+                        for (size_t i = 0; i < n; ++i)
+                        {
+                            endian::to_little(dst + i * ElemBytes, ElemBytes);
+                        }
+                    }
+
+                    jump(m_pos + n * ElemBytes);
+                    if (m_pos >= m_crc_limit)
+                        flush_checksum();
+
+                    elems += n * ElemBytes;
+                    count -= n;
+                }
+                return;
+            }
+            else
+            {
+                using adaptor_t = Adaptor<ByteContainer>;
+
+                auto_resize(bytes);
+                if (m_pos + bytes > adaptor_t::size(m_arr))
+                {
+                    fail(ResultCode::IncompleteSerialization);
+                    return;
+                }
+
+                auto* dst = std::bit_cast<uint8_t*>(adaptor_t::data(m_arr) + m_pos);
+                memcpy(dst, src, bytes);
+                if constexpr (endian::Current != endian::Endian::Little && ElemBytes > 1)
+                {
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        endian::to_little(dst + i * ElemBytes, ElemBytes);
+                    }
+                }
+
+                jump(m_pos + bytes);
+                if (m_pos >= m_crc_limit)
+                    flush_checksum();
+                return;
+            }
+
+            jump(m_pos + bytes);
+        }
+
+        // 一次性确认接下来的bytes字节可写，之后这段区域内的写入都走快速路径
+        // 空间不足时什么都不做，由逐字段的慢路径报告准确的错误位置
+        void check_bounds(size_t bytes) noexcept
+        {
+            if constexpr (Counting)
+            {
+                (void)bytes;
+            }
+            else
+            {
+                if (m_result != ResultCode::OK || m_pos + bytes <= m_checked_end)
+                    return;
+
+                // 流式模式下不为超过块大小的区域预先扩大缓冲区
+                if constexpr (Streaming)
+                {
+                    if (bytes > Adaptor<ByteContainer>::capacity(m_arr))
+                        return;
+                }
+
+                auto_resize(bytes);
+
+                const size_t size = Adaptor<ByteContainer>::size(m_arr);
+                if (m_pos + bytes <= size)
+                {
+                    m_checked_end = checked_end_limit(size);
+                }
+            }
+        }
+
         void bool_value(const bool b) noexcept
         {
             const uint8_t v = b ? 1 : 0;
@@ -341,12 +1290,92 @@ namespace infra::binary_serialization
         template<is_structure T>
         void structure(const T& s) noexcept
         {
+            if constexpr (is_framed_structure<T>)
+            {
+                framed_structure(s);
+            }
+            else if constexpr (is_memcpy_structure<T> && endian::Current == endian::Endian::Little)
+            {
+                values_impl<sizeof(T)>(&s, 1);
+            }
+            else if constexpr (fixed_serialized_size_v<T> != 0)
+            {
+                check_bounds(fixed_serialized_size_v<T>);
+
+                [[maybe_unused]] const size_t begin = current_offset();
+                to_bytes(*this, s);
+                INFRA_DEBUG_ASSERT_WITH_MSG(m_result != ResultCode::OK || current_offset() - begin == fixed_serialized_size_v<T>,
+                    "fixed_serialized_size does not match the bytes written by to_bytes.");
+            }
+            else
+            {
+                to_bytes(*this, s);
+            }
+        }
+
+        // | 字节数 | to_bytes写入的数据 |
+        template<is_framed_structure T>
+        void framed_structure(const T& s) noexcept
+        {
+            constexpr size_t declared_size = fixed_serialized_size<std::remove_cv_t<T>>::value;
+            if constexpr (declared_size != 0)
+            {
+                length(declared_size);
+            }
+            else if constexpr (Counting)
+            {
+                // 定长的长度前缀不需要知道实际的字节数
+                if (m_compact_length)
+                {
+                    length(measure_body(s));
+                }
+                else
+                {
+                    value(uint64_t{});
+                }
+            }
+            else
+            {
+                length(measure_body(s));
+            }
+
+            // 声明了fixed_serialized_size时长度前缀直接使用声明的值，必须与实际写入的字节数一致
+            [[maybe_unused]] const size_t begin = current_offset();
             to_bytes(*this, s);
+            if constexpr (declared_size != 0)
+            {
+                INFRA_DEBUG_ASSERT_WITH_MSG(m_result != ResultCode::OK || current_offset() - begin == declared_size,
+                    "fixed_serialized_size does not match the bytes written by to_bytes.");
+            }
+        }
+
+        // 只统计to_bytes写入的字节数，不包括framed结构体自己的长度前缀
+        template<is_structure T>
+        [[nodiscard]] size_t measure_body(const T& s) const noexcept
+        {
+            SizeCounter counter{};
+            Writer<SizeCounter> writer(counter);
+            writer.m_compact_length = m_compact_length;
+            to_bytes(writer, s);
+            return writer.current_offset();
         }
 
         template<is_c_array T>
         void c_array(const T& arr) noexcept
         {
+            // N维数值数组在内存中是连续的，直接整体拷贝
+            using scalar_t = std::remove_cv_t<std::remove_all_extents_t<T>>;
+            if constexpr (is_value<scalar_t> || (is_memcpy_structure<scalar_t> && endian::Current == endian::Endian::Little))
+            {
+                values_impl<sizeof(scalar_t)>(&arr, sizeof(T) / sizeof(scalar_t));
+                return;
+            }
+
+            if constexpr (fixed_serialized_size_v<T> != 0)
+            {
+                check_bounds(fixed_serialized_size_v<T>);
+            }
+
             for (size_t i = 0; i < std::extent_v<T>; ++i)
             {
                 const auto& elem = arr[i];
@@ -382,20 +1411,141 @@ namespace infra::binary_serialization
             );
         }
 
-    public:
-        explicit Writer(ByteContainer& arr)
-            : m_arr(arr)
+        // 数据区的字节: 不分块时计入header的校验和，分块时按块边界切开，分别计入每一块的校验和
+        void checksum_data(size_t offset, size_t size) noexcept
         {
-        }
+            if (m_chunk_size == 0)
+            {
+                update_checksum(offset, size);
+                return;
+            }
 
-        [[nodiscard]] ResultCode result() const noexcept
-        {
-            return m_result;
+            const uint8_t* data = std::bit_cast<uint8_t*>(Adaptor<ByteContainer>::data(m_arr)) + offset;
+            while (size > 0)
+            {
+                const size_t rest = m_chunk_size - m_chunk_filled;
+                const size_t n = size < rest ? size : rest;
+                m_chunk_checksum = update_crc32c_checksum(m_chunk_checksum, data, n);
+                m_chunk_filled += n;
+                data += n;
+                size -= n;
+
+                if (m_chunk_filled == m_chunk_size)
+                {
+                    m_chunk_checksums.push_back(m_chunk_checksum);
+                    m_chunk_checksum = Initial_CRC32C;
+                    m_chunk_filled = 0;
+                }
+            }
         }
 
-        [[nodiscard]] size_t current_offset() const noexcept
+        // 数据区全部计入校验和之后调用: 把分块表(分块数量 + 每块的length和CRC32C)编码到table中，并计入header的校验和
+        // 实际的分块数量与预留的count不一致时(两次to_bytes的结果不同)返回false
+        [[nodiscard]] bool encode_chunk_table(uint8_t* table, uint64_t count) noexcept
         {
-            return m_pos;
+            const size_t last_size = m_chunk_filled;
+            if (last_size > 0)
+            {
+                m_chunk_checksums.push_back(m_chunk_checksum);
+                m_chunk_checksum = Initial_CRC32C;
+                m_chunk_filled = 0;
+            }
+            if (m_chunk_checksums.size() != count)
+                return false;
+
+            memcpy(table, &count, sizeof(count));
+            endian::to_little(table, sizeof(count));
+
+            uint8_t* entry = table + detail::ChunkCountSize;
+            for (size_t i = 0; i < m_chunk_checksums.size(); ++i)
+            {
+                const uint32_t length = static_cast<uint32_t>((i + 1 == count && last_size > 0) ? last_size : m_chunk_size);
+                memcpy(entry, &length, sizeof(length));
+                endian::to_little(entry, sizeof(length));
+                memcpy(entry + sizeof(length), &m_chunk_checksums[i], sizeof(crc32c_t));
+                endian::to_little(entry + sizeof(length), sizeof(crc32c_t));
+                entry += detail::ChunkEntrySize;
+            }
+
+            m_crc32c_checksum = update_crc32c_checksum(m_crc32c_checksum, table, static_cast<size_t>(entry - table));
+            return true;
+        }
+
+        // 从offset开始，每写入FusedChecksumChunkSize字节就把这一块计入校验和
+        void begin_fused_checksum(size_t offset) noexcept
+        {
+            m_crc_pos = offset;
+            m_crc_limit = offset + detail::FusedChecksumChunkSize;
+            m_checked_end = checked_end_limit(m_checked_end);
+        }
+
+        void flush_checksum() noexcept
+        {
+            checksum_data(m_crc_pos, m_pos - m_crc_pos);
+            m_crc_pos = m_pos;
+            m_crc_limit = m_pos + detail::FusedChecksumChunkSize;
+        }
+
+        // 把剩余的 [m_crc_pos, m_pos) 计入校验和，之后不再增量计算
+        void end_fused_checksum() noexcept
+        {
+            checksum_data(m_crc_pos, m_pos - m_crc_pos);
+            m_crc_pos = m_pos;
+            m_crc_limit = SIZE_MAX;
+        }
+
+        // 流式模式: 把缓冲区中的 [0, m_pos) 计入校验和后输出到sink，之后从缓冲区开头继续写
+        void flush_stream() noexcept
+        {
+            using adaptor_t = Adaptor<ByteContainer>;
+
+            if (m_crc_limit != SIZE_MAX)
+            {
+                checksum_data(m_crc_pos, m_pos - m_crc_pos);
+            }
+
+            if (!adaptor_t::write(m_arr, std::bit_cast<const uint8_t*>(adaptor_t::data(m_arr)), m_pos))
+            {
+                fail(ResultCode::StreamWriteFailed);
+                return;
+            }
+
+            m_flushed += m_pos;
+            m_pos = 0;
+            m_checked_end = 0;
+            if (m_crc_limit != SIZE_MAX)
+            {
+                m_crc_pos = 0;
+                m_crc_limit = detail::FusedChecksumChunkSize;
+            }
+        }
+
+    public:
+        explicit Writer(ByteContainer& arr)
+            : m_arr(arr)
+        {
+        }
+
+        [[nodiscard]] ResultCode result() const noexcept
+        {
+            return m_result;
+        }
+
+        [[nodiscard]] size_t current_offset() const noexcept
+        {
+            return m_flushed + m_pos;
+        }
+
+        // 容器的长度前缀是否为varint
+        [[nodiscard]] bool compact_length() const noexcept
+        {
+            return m_compact_length;
+        }
+
+        // 计数模式(Writer<SizeCounter>)只统计字节数，写入的值不会被使用
+        [[nodiscard]] static constexpr bool counting() noexcept
+        {
+            return Counting;
         }
 
         [[nodiscard]] crc32c_t checksum() const noexcept
@@ -403,333 +1553,1692 @@ namespace infra::binary_serialization
             return m_crc32c_checksum;
         }
 
-        template<typename T>
-        void operator<<(const T& var) noexcept
+        // 批量写入count个连续存储的数值或memcpy结构体，编码结果与逐个 << 完全相同
+        template<is_bulk_serializable T>
+        void values(const T* src, size_t count) noexcept
+        {
+            if constexpr (is_value<T> || endian::Current == endian::Endian::Little)
+            {
+                values_impl<sizeof(T)>(src, count);
+            }
+            else
+            {
+                check_bounds(count * fixed_serialized_size_v<T>);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    structure(src[i]);
+                }
+            }
+        }
+
+        // 提前声明接下来至少会写入bytes字节(比如定长元素组成的数组)，只做一次扩容和边界检查
+        void ensure_bytes(size_t bytes) noexcept
+        {
+            check_bounds(bytes);
+        }
+
+        // var按当前的编码方式(compact_length)序列化后占用的字节数，不写入任何数据(会完整执行一遍var的to_bytes)
+        template<typename T>
+        [[nodiscard]] size_t measure(const T& var) const noexcept
+        {
+            SizeCounter counter{};
+            Writer<SizeCounter> writer(counter);
+            writer.m_compact_length = m_compact_length;
+            writer << var;
+            return writer.current_offset();
+        }
+
+        // LEB128变长整数，有符号数先做zigzag变换；与定长编码不兼容，读取时必须使用Reader::varint
+        template<is_serializable_integral T>
+        void varint(const T v) noexcept
+        {
+            uint64_t u = 0;
+            if constexpr (std::is_signed_v<T>)
+            {
+                u = detail::zigzag_encode(static_cast<int64_t>(v));
+            }
+            else
+            {
+                u = static_cast<uint64_t>(v);
+            }
+
+            if constexpr (Counting)
+            {
+                if (m_result == ResultCode::OK)
+                    jump(m_pos + detail::varint_size(u));
+            }
+            else
+            {
+                if (m_pos + detail::MaxVarintSize <= m_checked_end) [[likely]]
+                {
+                    auto* dst = std::bit_cast<uint8_t*>(Adaptor<ByteContainer>::data(m_arr) + m_pos);
+                    jump(m_pos + detail::encode_varint(u, dst));
+                    return;
+                }
+
+                uint8_t buffer[detail::MaxVarintSize];
+                values_impl<1>(buffer, detail::encode_varint(u, buffer));
+            }
+        }
+
+        // 容器的长度前缀: 默认为uint64_t，SerializeOptions::compact_length时为varint
+        void length(const uint64_t size) noexcept
+        {
+            if (m_compact_length)
+            {
+                varint(size);
+            }
+            else
+            {
+                value(size);
+            }
+        }
+
+        template<typename T>
+        void operator<<(const T& var) noexcept
+        {
+            static_assert(is_bool<T> || is_value<T> || is_c_array<T> || is_structure<T>);
+
+            if constexpr (is_bool<T>)
+            {
+                bool_value(var);
+            }
+            else if constexpr (is_value<T>)
+            {
+                value(var);
+            }
+            else if constexpr (is_c_array<T>)
+            {
+                c_array(var);
+            }
+            else
+            {
+                structure(var);
+            }
+        }
+
+        void abort() noexcept
+        {
+            fail(ResultCode::UserAbort);
+        }
+    };
+
+    template<typename ByteContainer>
+    class Reader
+    {
+        template<typename ByteContainer2, typename Object>
+        friend Result deserialize(const ByteContainer2&, Object&, const DeserializeOptions&);
+
+        template<typename Object>
+        friend ResultCode deserialize_range(const uint8_t*, size_t, Object&, bool) noexcept;
+
+        template<typename ByteContainer2>
+        friend class Reader;
+
+    private:
+        const ByteContainer& m_arr;
+        size_t m_pos = 0;
+        crc32c_t m_checksum = Initial_CRC32C;
+        ResultCode m_result = ResultCode::OK;
+
+        // [0, m_checked_end) 已确认在容器内，可以跳过边界检查直接读取
+        // 出错时清零，保证之后的读取全部走慢路径(fail-fast)
+        size_t m_checked_end = 0;
+
+        // 增量校验: [m_crc_pos, m_pos) 还没有计入校验和，m_pos到达m_crc_limit时计入
+        // 不开启时m_crc_limit为SIZE_MAX
+        size_t m_crc_pos = 0;
+        size_t m_crc_limit = SIZE_MAX;
+
+        // 容器长度前缀使用varint
+        bool m_compact_length = false;
+
+        // 数据区的结束位置，check_length只按这之前的字节检查长度前缀; 没有header时为容器末尾
+        size_t m_data_end = SIZE_MAX;
+
+        // 容器在deserialize返回后就会销毁(解压用的临时缓冲区)
+        bool m_transient = false;
+
+        void fail(ResultCode code) noexcept
+        {
+            m_result = code;
+            m_checked_end = 0;
+        }
+
+        // 快速路径不能越过m_crc_limit，这样只需要在慢路径中检查是否该计算校验和
+        [[nodiscard]] size_t checked_end_limit(size_t size) const noexcept
+        {
+            return size < m_crc_limit ? size : m_crc_limit;
+        }
+
+        // 数据区和容器两者中较早的结束位置
+        [[nodiscard]] size_t data_end() const noexcept
+        {
+            const size_t size = Adaptor<ByteContainer>::size(m_arr);
+            return m_data_end < size ? m_data_end : size;
+        }
+
+    private:
+        template<size_t Bytes>
+        void value_impl(void* dst) noexcept
+        {
+            using adaptor_t = Adaptor<ByteContainer>;
+
+            // 已经检查过的区域: 只需要一次比较
+            if (m_pos + Bytes <= m_checked_end) [[likely]]
+            {
+                memcpy(dst, adaptor_t::data(m_arr) + m_pos, Bytes);
+                endian::to_little(dst, Bytes);
+
+                m_pos += Bytes;
+                return;
+            }
+
+            // fail-fast
+            if (m_result != ResultCode::OK)
+                return;
+
+            const size_t size = adaptor_t::size(m_arr);
+            if (m_pos + Bytes > size)
+            {
+                fail(ResultCode::ByteContainerTooSmall);
+                return;
+            }
+            m_checked_end = checked_end_limit(size);
+
+            memcpy(dst, adaptor_t::data(m_arr) + m_pos, Bytes);
+            endian::to_little(dst, Bytes);
+
+            m_pos += Bytes;
+            if (m_pos >= m_crc_limit) [[unlikely]]
+                flush_checksum();
+        }
+
+        // 连续count个宽度为ElemBytes的数值，整体只做一次边界检查和一次memcpy
+        template<size_t ElemBytes>
+        void values_impl(void* dst, size_t count) noexcept
+        {
+            // fail-fast
+            if (m_result != ResultCode::OK)
+                return;
+
+            using adaptor_t = Adaptor<ByteContainer>;
+
+            const size_t bytes = ElemBytes * count;
+            if (bytes == 0)
+                return;
+
+            if (bytes > adaptor_t::size(m_arr) - m_pos)
+            {
+                fail(ResultCode::ByteContainerTooSmall);
+                return;
+            }
+
+            memcpy(dst, adaptor_t::data(m_arr) + m_pos, bytes);
+            if constexpr (endian::Current != endian::Endian::Little && ElemBytes > 1)
+            {
+                auto* elems = static_cast<uint8_t*>(dst);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    endian::to_little(elems + i * ElemBytes, ElemBytes);
+                }
+            }
+
+            m_pos += bytes;
+            if (m_pos >= m_crc_limit)
+                flush_checksum();
+        }
+
+        // 一次性确认接下来的bytes字节可读，之后这段区域内的读取都走快速路径
+        // 数据不足时什么都不做，由逐字段的慢路径报告准确的错误位置
+        void check_bounds(size_t bytes) noexcept
+        {
+            if (m_result != ResultCode::OK || m_pos + bytes <= m_checked_end)
+                return;
+
+            const size_t size = Adaptor<ByteContainer>::size(m_arr);
+            if (bytes <= size - m_pos)
+            {
+                m_checked_end = checked_end_limit(size);
+            }
+        }
+
+        void bool_value(bool& b) noexcept
+        {
+            uint8_t v = 0xff; // invalid value: v != 0 && v != 1
+            value_impl<sizeof(uint8_t)>(&v);
+
+            // if (v != 0 && v != 1)
+            if ((v & 0b11111110) != 0)
+            {
+                if (m_result == ResultCode::OK)
+                    fail(ResultCode::InvalidBoolValue);
+                return;
+            }
+
+            b = (v == 1);
+        }
+
+        template<is_value T>
+        void value(T& v) noexcept
+        {
+            value_impl<sizeof(T)>(&v);
+        }
+
+        template<is_structure T>
+        void structure(T& v) noexcept
+        {
+            if constexpr (is_framed_structure<T>)
+            {
+                framed_structure(v);
+            }
+            else if constexpr (is_memcpy_structure<T> && endian::Current == endian::Endian::Little)
+            {
+                values_impl<sizeof(T)>(&v, 1);
+            }
+            else
+            {
+                if constexpr (fixed_serialized_size_v<T> != 0)
+                {
+                    check_bounds(fixed_serialized_size_v<T>);
+                }
+
+                from_bytes(*this, v);
+            }
+        }
+
+        // from_bytes只能读取长度前缀声明的这段字节，没有读完的部分直接跳过
+        template<is_framed_structure T>
+        void framed_structure(T& v) noexcept
+        {
+            uint64_t size = 0;
+            length(size);
+            if (!check_length(size, 1))
+                return;
+
+            const uint8_t* data = borrow<uint8_t>(static_cast<size_t>(size));
+            if (data == nullptr)
+                return;
+
+            const detail::ByteRange range{ data, static_cast<size_t>(size) };
+            Reader<detail::ByteRange> frame(range);
+            frame.m_compact_length = m_compact_length;
+            frame.m_transient = m_transient;
+            from_bytes(frame, v);
+
+            if (frame.result() != ResultCode::OK)
+            {
+                fail(frame.result());
+            }
+        }
+
+        template<is_c_array T>
+        void c_array(T& arr) noexcept
+        {
+            // N维数值数组在内存中是连续的，直接整体拷贝
+            using scalar_t = std::remove_cv_t<std::remove_all_extents_t<T>>;
+            if constexpr (is_value<scalar_t> || (is_memcpy_structure<scalar_t> && endian::Current == endian::Endian::Little))
+            {
+                values_impl<sizeof(scalar_t)>(&arr, sizeof(T) / sizeof(scalar_t));
+                return;
+            }
+
+            if constexpr (fixed_serialized_size_v<T> != 0)
+            {
+                check_bounds(fixed_serialized_size_v<T>);
+            }
+
+            for (size_t i = 0; i < std::extent_v<T>; ++i)
+            {
+                auto& elem = arr[i];
+                using elem_t = std::remove_cvref_t<decltype(elem)>;
+
+                if constexpr (is_bool<elem_t>)
+                {
+                    bool_value(elem);
+                }
+                else if constexpr (is_value<elem_t>)
+                {
+                    value(elem);
+                }
+                else if constexpr (is_c_array<elem_t>)
+                {
+                    c_array(elem);
+                }
+                else
+                {
+                    structure(elem);
+                }
+            }
+        }
+
+        void update_checksum(size_t offset, size_t size) noexcept
+        {
+            using adaptor_t = Adaptor<ByteContainer>;
+
+            const uint8_t* data = std::bit_cast<uint8_t*>(adaptor_t::data(m_arr)) + offset;
+            if (size >= ParallelChecksumThreshold)
+            {
+                m_checksum = update_crc32c_checksum_parallel(m_checksum, data, size);
+            }
+            else
+            {
+                m_checksum = update_crc32c_checksum(m_checksum, data, size);
+            }
+        }
+
+        // 从offset开始，每读取FusedChecksumChunkSize字节就把这一块计入校验和
+        void begin_fused_checksum(size_t offset) noexcept
+        {
+            m_crc_pos = offset;
+            m_crc_limit = offset + detail::FusedChecksumChunkSize;
+            m_checked_end = checked_end_limit(m_checked_end);
+        }
+
+        void flush_checksum() noexcept
+        {
+            update_checksum(m_crc_pos, m_pos - m_crc_pos);
+            m_crc_pos = m_pos;
+            m_crc_limit = m_pos + detail::FusedChecksumChunkSize;
+        }
+
+        // 把 [m_crc_pos, end) 计入校验和，之后不再增量计算
+        // 已经计入的数据超过了end(读取越过了数据区)时返回false，此时校验和无效
+        [[nodiscard]] bool end_fused_checksum(size_t end) noexcept
+        {
+            m_crc_limit = SIZE_MAX;
+            if (m_crc_pos > end)
+                return false;
+
+            update_checksum(m_crc_pos, end - m_crc_pos);
+            m_crc_pos = end;
+            return true;
+        }
+
+    public:
+        explicit Reader(const ByteContainer& arr)
+            : m_arr(arr)
+        {
+        }
+
+        [[nodiscard]] ResultCode result() const noexcept
+        {
+            return m_result;
+        }
+
+        [[nodiscard]] crc32c_t checksum() const noexcept
+        {
+            return m_checksum;
+        }
+
+        [[nodiscard]] size_t current_offset() const noexcept
+        {
+            return m_pos;
+        }
+
+        // 容器的长度前缀是否为varint，延迟解码时需要原样传给deserialize_range
+        [[nodiscard]] bool compact_length() const noexcept
+        {
+            return m_compact_length;
+        }
+
+        // 容器在deserialize返回后就会销毁，此时不能保留指向容器的指针(延迟解码的字段需要复制或者立即解码)
+        [[nodiscard]] bool transient_buffer() const noexcept
+        {
+            return m_transient;
+        }
+
+        // 数据区中还没有读取的字节数; 在framed结构体的from_bytes中为这个结构体剩余的字节数
+        [[nodiscard]] size_t remaining() const noexcept
+        {
+            const size_t end = data_end();
+            return end > m_pos ? end - m_pos : 0;
+        }
+
+        // 跳过一个framed结构体或者Lazy字段(都以字节数作为长度前缀)，不解码
+        void skip_frame() noexcept
+        {
+            uint64_t size = 0;
+            length(size);
+            if (!check_length(size, 1))
+                return;
+
+            (void)borrow<uint8_t>(static_cast<size_t>(size));
+        }
+
+        // 批量读取count个连续存储的数值或memcpy结构体，与逐个 >> 的结果完全相同
+        template<is_bulk_serializable T>
+        void values(T* dst, size_t count) noexcept
+        {
+            if constexpr (is_value<T> || endian::Current == endian::Endian::Little)
+            {
+                values_impl<sizeof(T)>(dst, count);
+            }
+            else
+            {
+                check_bounds(count * fixed_serialized_size_v<T>);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    structure(dst[i]);
+                }
+            }
+        }
+
+        // 提前声明接下来至少会读取bytes字节(比如定长元素组成的数组)，只做一次边界检查
+        void ensure_bytes(size_t bytes) noexcept
+        {
+            check_bounds(bytes);
+        }
+
+        // 读取Writer::varint写入的整数，超出T的范围时失败(InvalidVarint)
+        template<is_serializable_integral T>
+        void varint(T& v) noexcept
+        {
+            // fail-fast
+            if (m_result != ResultCode::OK)
+                return;
+
+            using adaptor_t = Adaptor<ByteContainer>;
+
+            const size_t available = adaptor_t::size(m_arr) - m_pos;
+            const auto* src = std::bit_cast<const uint8_t*>(adaptor_t::data(m_arr)) + m_pos;
+
+            uint64_t u = 0;
+            const size_t n = detail::decode_varint(src, available, u);
+            if (n == 0)
+            {
+                fail(available < detail::MaxVarintSize ? ResultCode::ByteContainerTooSmall : ResultCode::InvalidVarint);
+                return;
+            }
+
+            if constexpr (std::is_signed_v<T>)
+            {
+                const int64_t i = detail::zigzag_decode(u);
+                if constexpr (sizeof(T) < sizeof(int64_t))
+                {
+                    if (i < std::numeric_limits<T>::min() || i > std::numeric_limits<T>::max())
+                    {
+                        fail(ResultCode::InvalidVarint);
+                        return;
+                    }
+                }
+                v = static_cast<T>(i);
+            }
+            else
+            {
+                if constexpr (sizeof(T) < sizeof(uint64_t))
+                {
+                    if (u > std::numeric_limits<T>::max())
+                    {
+                        fail(ResultCode::InvalidVarint);
+                        return;
+                    }
+                }
+                v = static_cast<T>(u);
+            }
+
+            m_pos += n;
+            if (m_pos >= m_crc_limit)
+                flush_checksum();
+        }
+
+        // 容器的长度前缀，与Writer::length对应
+        void length(uint64_t& size) noexcept
+        {
+            if (m_compact_length)
+            {
+                varint(size);
+            }
+            else
+            {
+                value(size);
+            }
+        }
+
+        // 读取容器的长度前缀之后、分配内存之前调用: 数据区剩余的字节放不下count个至少min_bytes字节的元素时失败
+        // 防止损坏或恶意的长度前缀引起巨大的内存分配
+        [[nodiscard]] bool check_length(uint64_t count, size_t min_bytes) noexcept
+        {
+            if (m_result != ResultCode::OK)
+                return false;
+
+            if (min_bytes == 0)
+                return count <= SIZE_MAX;
+
+            if (count > remaining() / min_bytes)
+            {
+                fail(ResultCode::LengthExceedsData);
+                return false;
+            }
+            return true;
+        }
+
+        // 元素依次为Elems...，每个元素至少占用min_serialized_size之和，加上其中的长度前缀
+        template<typename... Elems>
+        [[nodiscard]] bool check_length(uint64_t count) noexcept
+        {
+            const size_t prefix_size = m_compact_length ? 1 : sizeof(uint64_t);
+            return check_length(count, ((min_serialized_size_v<Elems> + length_prefix_count_v<Elems> * prefix_size) + ...));
+        }
+
+        // borrow<T>(count)能否成功，不改变任何状态
+        template<is_bulk_serializable T>
+        [[nodiscard]] bool can_borrow(size_t count) const noexcept
+        {
+            using adaptor_t = Adaptor<ByteContainer>;
+
+            if (m_result != ResultCode::OK || count > (adaptor_t::size(m_arr) - m_pos) / sizeof(T))
+                return false;
+
+            if constexpr (sizeof(T) > 1)
+            {
+                const auto* src = std::bit_cast<const uint8_t*>(adaptor_t::data(m_arr)) + m_pos;
+                return endian::Current == endian::Endian::Little && std::bit_cast<uintptr_t>(src) % alignof(T) == 0;
+            }
+            else
+            {
+                return true;
+            }
+        }
+
+        // 不拷贝，直接返回源缓冲区中接下来count个元素的地址并跳过它们，编码与values相同
+        // 返回的指针在源缓冲区销毁前有效；失败时返回nullptr
+        // 多字节元素要求小端序主机，并且数据在缓冲区中按alignof(T)对齐，否则失败(UnalignedView)
+        template<is_bulk_serializable T>
+        [[nodiscard]] const T* borrow(size_t count) noexcept
+        {
+            // fail-fast
+            if (m_result != ResultCode::OK)
+                return nullptr;
+
+            using adaptor_t = Adaptor<ByteContainer>;
+
+            if (count > (adaptor_t::size(m_arr) - m_pos) / sizeof(T))
+            {
+                fail(ResultCode::ByteContainerTooSmall);
+                return nullptr;
+            }
+
+            const auto* src = std::bit_cast<const uint8_t*>(adaptor_t::data(m_arr)) + m_pos;
+            if constexpr (sizeof(T) > 1)
+            {
+                if (endian::Current != endian::Endian::Little ||
+                    std::bit_cast<uintptr_t>(src) % alignof(T) != 0)
+                {
+                    fail(ResultCode::UnalignedView);
+                    return nullptr;
+                }
+            }
+
+            m_pos += count * sizeof(T);
+            if (m_pos >= m_crc_limit)
+                flush_checksum();
+
+            return reinterpret_cast<const T*>(src);
+        }
+
+        template<typename T>
+        void operator>>(T& var) noexcept
+        {
+            static_assert(is_bool<T> || is_value<T> || is_c_array<T> || is_structure<T>);
+
+            if constexpr (is_bool<T>)
+            {
+                bool_value(var);
+            }
+            else if constexpr (is_value<T>)
+            {
+                value(var);
+            }
+            else if constexpr (is_c_array<T>)
+            {
+                c_array(var);
+            }
+            else
+            {
+                structure(var);
+            }
+        }
+
+        void abort() noexcept
+        {
+            fail(ResultCode::UserAbort);
+        }
+    };
+
+    // 按varint编码的整数字段，可以直接作为结构体成员或容器元素: std::vector<Varint<uint32_t>>
+    template<is_serializable_integral T>
+    struct Varint
+    {
+        T value{};
+
+        friend constexpr bool operator==(const Varint&, const Varint&) noexcept = default;
+    };
+
+    template<typename T>
+    struct min_serialized_size<Varint<T>> : std::integral_constant<size_t, 1> {};
+
+    template<typename ByteContainer, typename T>
+    void to_bytes(
+        Writer<ByteContainer>& writer,
+        const Varint<T>& v
+    ) noexcept
+    {
+        writer.varint(v.value);
+    }
+
+    template<typename ByteContainer, typename T>
+    void from_bytes(
+        Reader<ByteContainer>& reader,
+        Varint<T>& v
+    ) noexcept
+    {
+        reader.varint(v.value);
+    }
+
+    template<typename Object>
+    ResultCode deserialize_range(const uint8_t* data, size_t size, Object& object, bool compact_length) noexcept
+    {
+        const detail::ByteRange range{ data, size };
+        Reader<detail::ByteRange> reader(range);
+        reader.m_compact_length = compact_length;
+        reader >> object;
+
+        if (reader.result() != ResultCode::OK)
+            return reader.result();
+
+        return reader.current_offset() == size ? ResultCode::OK : ResultCode::IncompleteSerialization;
+    }
+
+    namespace detail
+    {
+        // 压缩后的数据区: [uint64_t 原始字节数][LZ4 block]，原样写入
+        struct CompressedPayload
+        {
+            const uint8_t* data;
+            size_t size;
+        };
+
+        template<typename ByteContainer>
+        void to_bytes(
+            Writer<ByteContainer>& writer,
+            const CompressedPayload& payload
+        ) noexcept
+        {
+            writer.values(payload.data, payload.size);
+        }
+
+        // LZ4最大压缩比约为255:1，超过时认为原始字节数被篡改，避免巨大的内存分配
+        INFRA_HEADER_GLOBAL_CONSTEXPR uint64_t Lz4MaxRatio = 255;
+
+        INFRA_HEADER_GLOBAL bool compress_payload(const ScratchBuffer& raw, ScratchBuffer& packed) noexcept
+        {
+            const size_t raw_size = raw.bytes.size();
+            packed.bytes.resize(sizeof(uint64_t) + lz4_compress_bound(raw_size));
+
+            const uint64_t length = raw_size;
+            memcpy(packed.bytes.data(), &length, sizeof(length));
+            endian::to_little(packed.bytes.data(), sizeof(length));
+
+            const size_t compressed = lz4_compress(raw.bytes.data(), raw_size,
+                packed.bytes.data() + sizeof(uint64_t), packed.bytes.size() - sizeof(uint64_t));
+            if (compressed == 0)
+                return false;
+
+            packed.bytes.resize(sizeof(uint64_t) + compressed);
+            return true;
+        }
+
+        INFRA_HEADER_GLOBAL bool decompress_payload(const uint8_t* data, size_t size, ScratchBuffer& raw) noexcept
+        {
+            if (size < sizeof(uint64_t))
+                return false;
+
+            uint64_t length = 0;
+            memcpy(&length, data, sizeof(length));
+            endian::to_little(&length, sizeof(length));
+
+            const size_t compressed = size - sizeof(uint64_t);
+            if (length / Lz4MaxRatio > compressed || length > SIZE_MAX)
+                return false;
+
+            raw.bytes.resize(static_cast<size_t>(length));
+            return lz4_decompress(data + sizeof(uint64_t), compressed, raw.bytes.data(), raw.bytes.size());
+        }
+
+        INFRA_HEADER_GLOBAL const HeaderLayout& header_layout(const SerializeOptions& options) noexcept
+        {
+            // 需要flags的选项只能用V2表示
+            const bool v2 = options.header_version == HeaderVersion::V2 ||
+                options.compact_length ||
+                options.compression != Compression::None ||
+                options.chunk_size != 0;
+            return v2 ? HeaderV2Layout : HeaderV1Layout;
+        }
+
+        INFRA_HEADER_GLOBAL uint64_t chunk_count(size_t payload_size, const SerializeOptions& options) noexcept
+        {
+            if (options.chunk_size == 0)
+                return 0;
+
+            return payload_size / options.chunk_size + (payload_size % options.chunk_size != 0 ? 1 : 0);
+        }
+
+        // 分块表的字节数(含分块数量)
+        INFRA_HEADER_GLOBAL size_t chunk_table_size(size_t payload_size, const SerializeOptions& options) noexcept
+        {
+            if (options.chunk_size == 0)
+                return 0;
+
+            return static_cast<size_t>(chunk_count(payload_size, options)) * ChunkEntrySize + ChunkCountSize;
+        }
+
+        template<typename Object>
+        ResultCode measure_payload(const Object& object, const SerializeOptions& options, size_t& out_size)
+        {
+            SizeCounter counter{};
+            Writer<SizeCounter> writer(counter);
+            writer.m_compact_length = options.compact_length;
+
+            // 与实际写入时相同，从数据区的起点开始计数(to_bytes中可能会用到current_offset)
+            const size_t data_offset = header_layout(options).data_offset;
+            writer.jump(data_offset);
+            writer << object;
+            out_size = writer.current_offset() - data_offset;
+            return writer.result();
+        }
+
+        INFRA_HEADER_GLOBAL uint32_t header_flags(const SerializeOptions& options) noexcept
+        {
+            uint32_t flags = static_cast<uint32_t>(options.compression) & FlagCompressionMask;
+            if (options.compact_length)
+            {
+                flags |= FlagCompactLength;
+            }
+            if (options.chunk_size != 0)
+            {
+                flags |= FlagChunked;
+            }
+            return flags;
+        }
+
+        // header中data_length之后的部分: data_length, checksum, (V2)reserved
+        INFRA_HEADER_GLOBAL size_t encode_header_tail(const HeaderLayout& layout, uint64_t data_length, crc32c_t checksum_before_length, uint8_t* tail) noexcept
+        {
+            static_assert(ChecksumOffset == DataLengthOffset + DataLengthSize);
+            static_assert(ChecksumOffsetV2 == DataLengthOffsetV2 + DataLengthSizeV2);
+
+            const size_t tail_size = layout.data_offset - layout.data_length_offset;
+            memset(tail, 0, tail_size);
+
+            if (layout.data_length_size == sizeof(uint64_t))
+            {
+                memcpy(tail, &data_length, sizeof(uint64_t));
+            }
+            else
+            {
+                const data_length_t v1_length = static_cast<data_length_t>(data_length);
+                memcpy(tail, &v1_length, sizeof(data_length_t));
+            }
+            endian::to_little(tail, layout.data_length_size);
+
+            const crc32c_t checksum = update_crc32c_checksum(checksum_before_length, tail, layout.data_length_size);
+            memcpy(tail + layout.data_length_size, &checksum, ChecksumSize);
+            endian::to_little(tail + layout.data_length_size, ChecksumSize);
+
+            return tail_size;
+        }
+
+        // 流式序列化: 数据按块输出到sink，同时计算校验和，最后回填header中的data_length和checksum
+        template<typename Sink, typename Object>
+        Result serialize_to_stream(Sink& sink, const Object& object, const SerializeOptions& options)
+        {
+            using adaptor_t = Adaptor<Sink>;
+
+            Result result{};
+
+            const HeaderLayout& layout = header_layout(options);
+            const uint32_t flags = header_flags(options);
+
+            // header在sink中的起始位置
+            const size_t header_offset = adaptor_t::written(sink);
+
+            // 分块存储: 分块表在数据之前，先统计数据区的字节数，分块表占位之后回填
+            std::vector<uint8_t> chunk_table{};
+            uint64_t chunks = 0;
+            if (options.chunk_size != 0)
+            {
+                size_t payload_size = 0;
+                result.code = measure_payload(object, options, payload_size);
+                if (result.code != ResultCode::OK)
+                {
+                    return result;
+                }
+                chunks = chunk_count(payload_size, options);
+                chunk_table.resize(chunk_table_size(payload_size, options));
+            }
+
+            adaptor_t::resize(sink, layout.data_offset);
+            Writer<Sink> writer(sink);
+            writer.m_compact_length = options.compact_length;
+            writer.m_chunk_size = options.chunk_size;
+
+            // save magic (+flags), data length和checksum先占位
+            writer.values(layout.magic, MagicSize);
+            if (layout.version == HeaderVersion::V2)
+            {
+                writer << flags;
+            }
+            writer.update_checksum(MagicOffset, layout.prefix_size);
+
+            // chunk table (占位) + data
+            writer.jump(layout.data_offset);
+            if (!chunk_table.empty())
+            {
+                writer.values(chunk_table.data(), chunk_table.size());
+            }
+            // 分块表较大时缓冲区可能已经输出过，数据从缓冲区的当前位置开始
+            writer.begin_fused_checksum(writer.m_pos);
+            writer << object;
+            if (writer.result() == ResultCode::OK)
+            {
+                writer.flush_stream();
+            }
+            if (writer.result() != ResultCode::OK)
+            {
+                result.code = writer.result();
+                return result;
+            }
+
+            // 分块表已经随数据输出，回填每块的length和CRC32C
+            if (options.chunk_size != 0)
+            {
+                if (!writer.encode_chunk_table(chunk_table.data(), chunks))
+                {
+                    result.code = ResultCode::IncompleteSerialization;
+                    return result;
+                }
+                if (!adaptor_t::patch(sink, header_offset + layout.data_offset, chunk_table.data(), chunk_table.size()))
+                {
+                    result.code = ResultCode::StreamWriteFailed;
+                    return result;
+                }
+            }
+
+            const size_t data_size = writer.current_offset() - layout.data_offset;
+            if (data_size > layout.max_data_length)
+            {
+                result.code = ResultCode::DataTooLarge;
+                return result;
+            }
+
+            // data length + checksum
+            uint8_t tail[DataOffsetV2 - DataLengthOffsetV2];
+            const size_t tail_size = encode_header_tail(layout, data_size, writer.checksum(), tail);
+            if (!adaptor_t::patch(sink, header_offset + layout.data_length_offset, tail, tail_size))
+            {
+                result.code = ResultCode::StreamWriteFailed;
+                return result;
+            }
+
+            result.bytes = layout.data_offset + data_size;
+            return result;
+        }
+    }
+
+    template<typename ByteContainer, typename Object>
+    Result serialize(ByteContainer& byte_array, const Object& object, const SerializeOptions& options)
+    {
+        using adaptor_t = Adaptor<ByteContainer>;
+        static_assert(is_byte_type<typename adaptor_t::byte_type>, "you must use a byte(unsigned) container.");
+        
+        // 先编码到临时缓冲区并压缩，再把压缩结果作为数据区写入
+        if constexpr (!std::is_same_v<Object, detail::CompressedPayload>)
+        {
+            if (options.compression != Compression::None)
+            {
+                Result result{};
+
+                detail::ScratchBuffer raw{};
+                Writer<detail::ScratchBuffer> writer(raw);
+                writer.m_compact_length = options.compact_length;
+                writer << object;
+                if (writer.result() != ResultCode::OK)
+                {
+                    result.code = writer.result();
+                    return result;
+                }
+
+                detail::ScratchBuffer packed{};
+                if (!detail::compress_payload(raw, packed))
+                {
+                    result.code = ResultCode::IncompleteSerialization;
+                    return result;
+                }
+
+                return serialize(byte_array, detail::CompressedPayload{ packed.bytes.data(), packed.bytes.size() }, options);
+            }
+        }
+
+        if constexpr (detail::is_streaming_container<ByteContainer>)
+        {
+            return detail::serialize_to_stream(byte_array, object, options);
+        }
+
+        Result result{};
+
+        const detail::HeaderLayout& layout = detail::header_layout(options);
+        const uint32_t flags = detail::header_flags(options);
+
+        if constexpr (adaptor_t::resizeable())
+        {
+            size_t reserve_size = options.size_hint;
+            if (options.exact_size)
+            {
+                result = serialized_size(object, reserve_size, options);
+                if (!result)
+                {
+                    return result;
+                }
+            }
+
+            if (reserve_size > adaptor_t::capacity(byte_array))
+            {
+                adaptor_t::reserve(byte_array, reserve_size);
+            }
+        }
+
+        adaptor_t::resize(byte_array, layout.data_offset);
+        if (adaptor_t::size(byte_array) < layout.data_offset)
+        {
+            result.code = ResultCode::ByteContainerTooSmall;
+            return result;
+        }
+
+        // 分块存储: 分块表在数据之前，先统计数据区的字节数，分块表占位之后回填
+        std::vector<uint8_t> chunk_table{};
+        uint64_t chunks = 0;
+        if (options.chunk_size != 0)
+        {
+            size_t payload_size = 0;
+            result.code = detail::measure_payload(object, options, payload_size);
+            if (result.code != ResultCode::OK)
+            {
+                return result;
+            }
+            chunks = detail::chunk_count(payload_size, options);
+            chunk_table.resize(detail::chunk_table_size(payload_size, options));
+        }
+        const size_t payload_offset = layout.data_offset + chunk_table.size();
+
+        Writer<ByteContainer> writer(byte_array);
+        writer.m_compact_length = options.compact_length;
+        writer.m_chunk_size = options.chunk_size;
+
+        // save magic (+flags)
+        writer.values(layout.magic, detail::MagicSize);
+        if (layout.version == HeaderVersion::V2)
+        {
+            writer << flags;
+        }
+        writer.update_checksum(detail::MagicOffset, layout.prefix_size);
+        ResultCode result_code = writer.result();
+        if (result_code != ResultCode::OK)
+        {
+            result.code = result_code;
+            return result;
+        }
+
+        // data length (写完数据后再填充)
+        // checksum (写完数据后再填充)
+
+        // chunk table (分块存储时先占位，写完数据后再填充)
+        writer.jump(layout.data_offset);
+        if (!chunk_table.empty())
+        {
+            writer.values(chunk_table.data(), chunk_table.size());
+        }
+
+        // data
+        if (options.fused_checksum)
+        {
+            writer.begin_fused_checksum(payload_offset);
+        }
+        writer << object;
+        result_code = writer.result();
+        if (result_code != ResultCode::OK)
+        {
+            result.code = result_code;
+            return result;
+        }
+        if (writer.current_offset() - layout.data_offset > layout.max_data_length)
+        {
+            result.code = ResultCode::DataTooLarge;
+            return result;
+        }
+        if (options.fused_checksum)
+        {
+            writer.end_fused_checksum();
+        }
+        else
+        {
+            writer.checksum_data(payload_offset, writer.current_offset() - payload_offset);
+        }
+        const size_t data_end = writer.current_offset();
+        const size_t data_size = data_end - layout.data_offset;
+
+        // chunk table (分块存储时)
+        if (options.chunk_size != 0)
+        {
+            if (!writer.encode_chunk_table(chunk_table.data(), chunks))
+            {
+                result.code = ResultCode::IncompleteSerialization;
+                return result;
+            }
+            writer.jump(layout.data_offset);
+            writer.values(chunk_table.data(), chunk_table.size());
+        }
+
+        // data length + checksum (+reserved)
+        uint8_t tail[detail::DataOffsetV2 - detail::DataLengthOffsetV2];
+        const size_t tail_size = detail::encode_header_tail(layout, data_size, writer.checksum(), tail);
+        writer.jump(layout.data_length_offset);
+        writer.values(tail, tail_size);
+        result_code = writer.result();
+        if (result_code != ResultCode::OK)
+        {
+            result.code = result_code;
+            return result;
+        }
+
+        // 容器会按倍数或者按定长结构体的字节数提前扩容，这里裁掉多余的部分
+        if constexpr (adaptor_t::resizeable())
+        {
+            adaptor_t::resize(byte_array, data_end);
+        }
+
+        result.bytes = data_end;
+        return result;
+    }
+
+    // 计算object序列化后的总字节数(含header)，不写入任何数据
+    template<typename Object>
+    Result serialized_size(const Object& object, size_t& out_size, const SerializeOptions& options)
+    {
+        Result result{};
+
+        // 压缩后的大小只能实际压缩一遍才知道
+        if constexpr (!std::is_same_v<Object, detail::CompressedPayload>)
+        {
+            if (options.compression != Compression::None)
+            {
+                detail::ScratchBuffer raw{};
+                Writer<detail::ScratchBuffer> writer(raw);
+                writer.m_compact_length = options.compact_length;
+                writer << object;
+                result.code = writer.result();
+                if (result.code != ResultCode::OK)
+                {
+                    return result;
+                }
+
+                detail::ScratchBuffer packed{};
+                if (!detail::compress_payload(raw, packed))
+                {
+                    result.code = ResultCode::IncompleteSerialization;
+                    return result;
+                }
+
+                out_size = detail::header_layout(options).data_offset + packed.bytes.size() +
+                    detail::chunk_table_size(packed.bytes.size(), options);
+                return result;
+            }
+        }
+
+        size_t payload_size = 0;
+        result.code = detail::measure_payload(object, options, payload_size);
+        if (result.code != ResultCode::OK)
+        {
+            return result;
+        }
+
+        out_size = detail::header_layout(options).data_offset + payload_size + detail::chunk_table_size(payload_size, options);
+        return result;
+    }
+
+    namespace detail
+    {
+        // deserialize和verify_chunks共用的header字段
+        struct FrameHeader
+        {
+            const HeaderLayout* layout = nullptr;
+            uint32_t flags = 0;
+            size_t data_size = 0;
+            crc32c_t checksum = Initial_CRC32C;
+        };
+
+        // 读取header(同时兼容V1和V2)，读取完成后reader位于数据区的开头
+        template<typename ByteContainer>
+        ResultCode read_header(Reader<ByteContainer>& reader, const ByteContainer& byte_array, FrameHeader& header) noexcept
+        {
+            using adaptor_t = Adaptor<ByteContainer>;
+
+            const size_t container_size = adaptor_t::size(byte_array);
+            if (container_size <= DataOffset)
+            {
+                return ResultCode::ByteContainerTooSmall;
+            }
+
+            // magic
+            uint8_t magic[MagicSize] = {};
+            reader >> magic;
+
+            if (memcmp(magic, MagicValue, MagicSize) == 0)
+            {
+                header.layout = &HeaderV1Layout;
+            }
+            else if (memcmp(magic, MagicValueV2, MagicSize) == 0)
+            {
+                header.layout = &HeaderV2Layout;
+            }
+            else
+            {
+                return ResultCode::MagicNumberIncorrect;
+            }
+
+            const HeaderLayout& layout = *header.layout;
+            if (container_size <= layout.data_offset)
+            {
+                return ResultCode::ByteContainerTooSmall;
+            }
+
+            // flags
+            if (layout.version == HeaderVersion::V2)
+            {
+                reader >> header.flags;
+                if ((header.flags & ~FlagsSupported) != 0 ||
+                    (header.flags & FlagCompressionMask) > static_cast<uint32_t>(Compression::Lz4))
+                {
+                    return ResultCode::UnsupportedHeader;
+                }
+            }
+
+            // data length
+            uint64_t data_length = 0;
+            if (layout.data_length_size == sizeof(uint64_t))
+            {
+                reader >> data_length;
+            }
+            else
+            {
+                data_length_t v1_length = 0;
+                reader >> v1_length;
+                data_length = v1_length;
+            }
+
+            // byte_array的容量一定要比文件大
+            if (data_length > container_size - layout.data_offset)
+            {
+                return ResultCode::ByteContainerTooSmall;
+            }
+            header.data_size = static_cast<size_t>(data_length);
+
+            // checksum
+            reader >> header.checksum;
+
+            if (layout.version == HeaderVersion::V2)
+            {
+                uint32_t reserved = 0;
+                reader >> reserved;
+                if (reserved != 0)
+                {
+                    return ResultCode::UnsupportedHeader;
+                }
+            }
+
+            return reader.result();
+        }
+
+        // 分块存储: 用header的校验和检查数据区开头的分块表，然后解析出每一块的位置
+        // payload_size为所有块的总字节数，这些块位于数据区的末尾(分块表之后)
+        INFRA_HEADER_GLOBAL ResultCode read_chunk_table(
+            const uint8_t* frame,
+            const FrameHeader& header,
+            std::vector<ChunkInfo>& chunks,
+            size_t& payload_size
+        ) noexcept
         {
-            static_assert(is_bool<T> || is_value<T> || is_c_array<T> || is_structure<T>);
+            const HeaderLayout& layout = *header.layout;
+            const uint8_t* data = frame + layout.data_offset;
 
-            if constexpr (is_bool<T>)
+            if (header.data_size < ChunkCountSize)
             {
-                bool_value(var);
+                return ResultCode::ChecksumIncorrect;
             }
-            else if constexpr (is_value<T>)
+
+            uint64_t count = 0;
+            memcpy(&count, data, sizeof(count));
+            endian::to_little(&count, sizeof(count));
+
+            // 分块数量损坏时无法确定分块表的范围，只能当作校验失败
+            if (count > (header.data_size - ChunkCountSize) / ChunkEntrySize)
             {
-                value(var);
+                return ResultCode::ChecksumIncorrect;
             }
-            else if constexpr (is_c_array<T>)
+
+            const size_t table_size = static_cast<size_t>(count) * ChunkEntrySize + ChunkCountSize;
+            payload_size = header.data_size - table_size;
+
+            crc32c_t checksum = update_crc32c_checksum(Initial_CRC32C, frame + MagicOffset, layout.prefix_size);
+            checksum = update_crc32c_checksum(checksum, data, table_size);
+            checksum = update_crc32c_checksum(checksum, frame + layout.data_length_offset, layout.data_length_size);
+            if (checksum != header.checksum)
             {
-                c_array(var);
+                return ResultCode::ChecksumIncorrect;
             }
-            else
+
+            chunks.resize(static_cast<size_t>(count));
+            const uint8_t* entry = data + ChunkCountSize;
+            const uint8_t* payload = data + table_size;
+            size_t offset = 0;
+            for (auto& chunk : chunks)
             {
-                structure(var);
+                uint32_t length = 0;
+                memcpy(&length, entry, sizeof(length));
+                endian::to_little(&length, sizeof(length));
+                memcpy(&chunk.checksum, entry + sizeof(length), sizeof(crc32c_t));
+                endian::to_little(&chunk.checksum, sizeof(crc32c_t));
+                entry += ChunkEntrySize;
+
+                if (length > payload_size - offset)
+                {
+                    return ResultCode::InvalidChunkTable;
+                }
+
+                chunk.data = payload + offset;
+                chunk.size = length;
+                offset += length;
             }
-        }
 
-        void abort() noexcept
-        {
-            m_result = ResultCode::UserAbort;
+            if (offset != payload_size)
+            {
+                return ResultCode::InvalidChunkTable;
+            }
+            return ResultCode::OK;
         }
-    };
+    }
 
-    template<typename ByteContainer>
-    class Reader
+    template<typename ByteContainer, typename Object>
+    Result deserialize(const ByteContainer& byte_array, Object& object, const DeserializeOptions& options)
     {
-        template<typename ByteContainer2, typename Object>
-        friend Result deserialize(const ByteContainer2&, Object&);
+        using adaptor_t = Adaptor<ByteContainer>;
+        static_assert(is_byte_type<typename adaptor_t::byte_type>, "you must use a byte(unsigned) container.");
 
-    private:
-        const ByteContainer& m_arr;
-        size_t m_pos = 0;
-        crc32c_t m_checksum = Initial_CRC32C;
-        ResultCode m_result = ResultCode::OK;
+        Result result{};
 
-    private:
-        template<size_t Bytes>
-        void value_impl(void* dst) noexcept
-        {
-            // fail-fast
-            if (m_result != ResultCode::OK)
-                return;
+        Reader<ByteContainer> reader(byte_array);
 
-            using adaptor_t = Adaptor<ByteContainer>;
-            
-            if (m_pos + Bytes > adaptor_t::size(m_arr))
-            {
-                m_result = ResultCode::ByteContainerTooSmall;
-                return;
-            }
+        detail::FrameHeader header{};
+        result.code = detail::read_header(reader, byte_array, header);
+        if (result.code != ResultCode::OK)
+        {
+            return result;
+        }
 
-            memcpy(dst, adaptor_t::data(m_arr) + m_pos, Bytes);
-            endian::to_little(dst, Bytes);
+        const detail::HeaderLayout* layout = header.layout;
+        const uint32_t flags = header.flags;
+        const size_t data_size = header.data_size;
+        const crc32c_t checksum = header.checksum;
+        reader.m_compact_length = (flags & detail::FlagCompactLength) != 0;
 
-            m_pos += Bytes;
-        }
+        const uint8_t* frame = std::bit_cast<const uint8_t*>(adaptor_t::data(byte_array));
 
-        void bool_value(bool& b) noexcept
+        // 分块存储: 先检查分块表，再并行校验所有的块，之后的读取不需要再计算校验和
+        const bool chunked = (flags & detail::FlagChunked) != 0;
+        size_t payload_size = data_size;
+        if (chunked)
         {
-            uint8_t v = 0xff; // invalid value: v != 0 && v != 1
-            value_impl<sizeof(uint8_t)>(&v);
-
-            // if (v != 0 && v != 1)
-            if ((v & 0b11111110) != 0)
+            std::vector<detail::ChunkInfo> chunks{};
+            result.code = detail::read_chunk_table(frame, header, chunks, payload_size);
+            if (result.code != ResultCode::OK)
             {
-                m_result = ResultCode::InvalidBoolValue;
-                return;
+                return result;
             }
 
-            b = (v == 1);
+            std::vector<uint8_t> corrupt(chunks.size(), 0);
+            detail::check_chunks(chunks.data(), chunks.size(), corrupt.data());
+            for (const uint8_t c : corrupt)
+            {
+                if (c != 0)
+                {
+                    result.code = ResultCode::ChecksumIncorrect;
+                    return result;
+                }
+            }
         }
-
-        template<is_value T>
-        void value(T& v) noexcept
+        else
         {
-            value_impl<sizeof(T)>(&v);
+            reader.update_checksum(detail::MagicOffset, layout->prefix_size);
         }
 
-        template<is_structure T>
-        void structure(T& v) noexcept
-        {
-            from_bytes(*this, v);
-        }
+        // 分块表之后才是实际的数据
+        const size_t payload_offset = layout->data_offset + data_size - payload_size;
+        reader.m_pos = payload_offset;
 
-        template<is_c_array T>
-        void c_array(T& arr) noexcept
+        // 长度前缀不能越过数据区(之后是容器中的其他数据)
+        reader.m_data_end = payload_offset + payload_size;
+
+        // 压缩数据: 先校验压缩后的字节，再解压到临时缓冲区中读取
+        if ((flags & detail::FlagCompressionMask) != 0)
         {
-            for (size_t i = 0; i < std::extent_v<T>; ++i)
+            if constexpr (holds_buffer_view_v<Object>)
             {
-                auto& elem = arr[i];
-                using elem_t = std::remove_cvref_t<decltype(elem)>;
-
-                if constexpr (is_bool<elem_t>)
-                {
-                    bool_value(elem);
-                }
-                else if constexpr (is_value<elem_t>)
+                result.code = ResultCode::DecompressionFailed;
+                return result;
+            }
+            else
+            {
+                if (!chunked)
                 {
-                    value(elem);
+                    reader.update_checksum(layout->data_offset, data_size);
+                    reader.update_checksum(layout->data_length_offset, layout->data_length_size);
+                    if (reader.checksum() != checksum)
+                    {
+                        result.code = ResultCode::ChecksumIncorrect;
+                        return result;
+                    }
                 }
-                else if constexpr (is_c_array<elem_t>)
+
+                detail::ScratchBuffer raw{};
+                if (!detail::decompress_payload(frame + payload_offset, payload_size, raw))
                 {
-                    c_array(elem);
+                    result.code = ResultCode::DecompressionFailed;
+                    return result;
                 }
-                else
+
+                Reader<detail::ScratchBuffer> raw_reader(raw);
+                raw_reader.m_compact_length = reader.m_compact_length;
+                raw_reader.m_transient = true;
+                raw_reader >> object;
+                if (raw_reader.result() != ResultCode::OK)
                 {
-                    structure(elem);
+                    result.code = raw_reader.result();
+                    return result;
                 }
-            }
-        }
-
-        void update_checksum(size_t offset, size_t size) noexcept
-        {
-            using adaptor_t = Adaptor<ByteContainer>;
-
-            m_checksum = update_crc32c_checksum(
-                m_checksum,
-                std::bit_cast<uint8_t*>(adaptor_t::data(m_arr)) + offset,
-                size
-            );
-        }
 
-    public:
-        explicit Reader(const ByteContainer& arr)
-            : m_arr(arr)
-        {
-        }
-
-        [[nodiscard]] ResultCode result() const noexcept
-        {
-            return m_result;
-        }
-
-        [[nodiscard]] crc32c_t checksum() const noexcept
-        {
-            return m_checksum;
+                result.bytes = layout->data_offset + data_size;
+                return result;
+            }
         }
 
-        [[nodiscard]] size_t current_offset() const noexcept
+        if (chunked)
         {
-            return m_pos;
+            // data (已经校验过)
+            reader >> object;
         }
-
-        template<typename T>
-        void operator>>(T& var) noexcept
+        else if (options.fused_checksum)
         {
-            static_assert(is_bool<T> || is_value<T> || is_c_array<T> || is_structure<T>);
+            // data (读取的同时计算校验和)
+            reader.begin_fused_checksum(layout->data_offset);
+            reader >> object;
 
-            if constexpr (is_bool<T>)
+            if (reader.end_fused_checksum(layout->data_offset + data_size))
             {
-                bool_value(var);
+                reader.update_checksum(layout->data_length_offset, layout->data_length_size);
             }
-            else if constexpr (is_value<T>)
+            else
             {
-                value(var);
+                // 读取越过了数据区，增量结果作废，重新完整计算
+                reader.m_checksum = Initial_CRC32C;
+                reader.update_checksum(detail::MagicOffset, layout->prefix_size);
+                reader.update_checksum(layout->data_offset, data_size);
+                reader.update_checksum(layout->data_length_offset, layout->data_length_size);
             }
-            else if constexpr (is_c_array<T>)
+
+            // 校验失败优先于读取错误: 数据损坏时读取错误只是结果
+            if (reader.checksum() != checksum)
             {
-                c_array(var);
+                result.code = ResultCode::ChecksumIncorrect;
+                return result;
             }
-            else
+        }
+        else
+        {
+            reader.update_checksum(layout->data_offset, data_size);
+            reader.update_checksum(layout->data_length_offset, layout->data_length_size);
+            if (reader.checksum() != checksum)
             {
-                structure(var);
+                result.code = ResultCode::ChecksumIncorrect;
+                return result;
             }
+
+            // data
+            reader >> object;
         }
 
-        void abort() noexcept
+        const ResultCode result_code = reader.result();
+        if (result_code != ResultCode::OK)
         {
-            m_result = ResultCode::UserAbort;
+            result.code = result_code;
+            return result;
         }
-    };
 
-    template<typename ByteContainer, typename Object>
-    Result serialize(ByteContainer& byte_array, const Object& object)
+        result.bytes = layout->data_offset + data_size;
+        return result;
+    }
+
+    template<typename ByteContainer>
+    Result verify_chunks(const ByteContainer& byte_array, std::vector<size_t>& corrupt_chunks, unsigned threads)
     {
         using adaptor_t = Adaptor<ByteContainer>;
         static_assert(is_byte_type<typename adaptor_t::byte_type>, "you must use a byte(unsigned) container.");
-        
+
         Result result{};
+        corrupt_chunks.clear();
+
+        Reader<ByteContainer> reader(byte_array);
 
-        adaptor_t::resize(byte_array, detail::DataOffset);
-        if (adaptor_t::size(byte_array) < detail::DataOffset)
+        detail::FrameHeader header{};
+        result.code = detail::read_header(reader, byte_array, header);
+        if (result.code != ResultCode::OK)
         {
-            result.code = ResultCode::ByteContainerTooSmall;
             return result;
         }
 
-        Writer<ByteContainer> writer(byte_array);
-
-        // save magic
-        writer << detail::MagicValue;
-        writer.update_checksum(detail::MagicOffset, detail::MagicSize);
-        ResultCode result_code = writer.result();
-        if (result_code != ResultCode::OK)
+        if ((header.flags & detail::FlagChunked) == 0)
         {
-            result.code = result_code;
+            result.code = ResultCode::UnsupportedHeader;
             return result;
         }
 
-        // data length (写完数据后再填充)
-        // checksum (写完数据后再填充)
-
-        // data
-        writer.jump(detail::DataOffset);
-        writer << object;
-        result_code = writer.result();
-        if (result_code != ResultCode::OK)
+        std::vector<detail::ChunkInfo> chunks{};
+        size_t payload_size = 0;
+        result.code = detail::read_chunk_table(std::bit_cast<const uint8_t*>(adaptor_t::data(byte_array)), header, chunks, payload_size);
+        if (result.code != ResultCode::OK)
         {
-            result.code = result_code;
             return result;
         }
-        const data_length_t data_length = static_cast<data_length_t>(writer.current_offset() - detail::DataOffset);
-        writer.update_checksum(detail::DataOffset, static_cast<size_t>(data_length));
 
-        // data length
-        writer.jump(detail::DataLengthOffset);
-        writer << data_length;
-        result_code = writer.result();
-        if (result_code != ResultCode::OK)
+        std::vector<uint8_t> corrupt(chunks.size(), 0);
+        detail::check_chunks(chunks.data(), chunks.size(), corrupt.data(), threads);
+        for (size_t i = 0; i < corrupt.size(); ++i)
         {
-            result.code = result_code;
-            return result;
+            if (corrupt[i] != 0)
+            {
+                corrupt_chunks.push_back(i);
+            }
         }
-        writer.update_checksum(detail::DataLengthOffset, detail::DataLengthSize);
 
-        // checksum
-        const crc32c_t checksum = writer.checksum();
-        writer.jump(detail::ChecksumOffset);
-        writer << checksum;
-        result_code = writer.result();
-        if (result_code != ResultCode::OK)
+        if (!corrupt_chunks.empty())
         {
-            result.code = result_code;
+            result.code = ResultCode::ChecksumIncorrect;
             return result;
         }
 
+        result.bytes = header.layout->data_offset + header.data_size;
         return result;
     }
+}
 
-    template<typename ByteContainer, typename Object>
-    Result deserialize(const ByteContainer& byte_array, Object& object)
-    {
-        using adaptor_t = Adaptor<ByteContainer>;
-        static_assert(is_byte_type<typename adaptor_t::byte_type>, "you must use a byte(unsigned) container.");
+#pragma endregion HPP
 
-        Result result{};
 
-        if (adaptor_t::size(byte_array) <= detail::DataOffset)
-        {
-            result.code = ResultCode::ByteContainerTooSmall;
-            return result;
-        }
 
-        Reader<ByteContainer> reader(byte_array);
+#pragma region CPP
+#ifdef INFRA_BINARY_SERIALIZATION_IMPL
+
+#if INFRA_ARCH_X86
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+    #include <nmmintrin.h>
+    #include <immintrin.h> // pclmul, avx-512, bmi2
+#elif INFRA_ARCH_ARM
+    #include <arm_acle.h>
+#endif
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace infra::binary_serialization
+{
+    crc32c_t update_crc32c_checksum_parallel(
+        crc32c_t origin,
+        const uint8_t* data,
+        size_t size,
+        unsigned threads
+    ) noexcept
+    {
+        // 每个线程分到的最少字节数，太小时线程的创建开销比计算还大
+        constexpr size_t MinChunkSize = 4 * 1024 * 1024;
 
-        // magic
-        decltype(std::declval<detail::Header>().magic) magic = {};
-        reader >> magic;
-        if (memcmp(magic, detail::MagicValue, detail::MagicSize) != 0)
+        if (threads == 0)
         {
-            result.code = ResultCode::MagicNumberIncorrect;
-            return result;
+            threads = std::thread::hardware_concurrency();
+        }
+        const size_t max_chunks = size / MinChunkSize;
+        const size_t chunks = std::min<size_t>(threads, max_chunks);
+        if (chunks <= 1)
+        {
+            return update_crc32c_checksum(origin, data, size);
         }
 
-        // data length
-        decltype(std::declval<detail::Header>().data_length) data_length = 0;
-        reader >> data_length;
+        // 第0块由当前线程从origin开始计算，其余块从Initial_CRC32C开始计算后合并
+        const size_t chunk_size = size / chunks;
+        std::vector<crc32c_t> partial(chunks, Initial_CRC32C);
+        std::vector<std::thread> workers{};
+        size_t spawned = 1;
 
-        // byte_array的容量一定要比文件大
-        if (adaptor_t::size(byte_array) < data_length + detail::DataOffset)
+        try
         {
-            result.code = ResultCode::ByteContainerTooSmall;
-            return result;
+            workers.reserve(chunks - 1);
+            for (; spawned < chunks; ++spawned)
+            {
+                const size_t begin = spawned * chunk_size;
+                const size_t length = (spawned + 1 == chunks) ? size - begin : chunk_size;
+                workers.emplace_back([&partial, data, begin, length, spawned]() noexcept {
+                    partial[spawned] = update_crc32c_checksum(Initial_CRC32C, data + begin, length);
+                });
+            }
+        }
+        catch (...)
+        {
+            // 创建线程失败: 已经创建的线程照常工作，剩下的块由当前线程计算
         }
 
-        // checksum
-        decltype(std::declval<detail::Header>().checksum) checksum = Initial_CRC32C;
-        reader >> checksum;
-
-        reader.update_checksum(detail::MagicOffset, detail::MagicSize);
-        reader.update_checksum(detail::DataOffset, data_length);
-        reader.update_checksum(detail::DataLengthOffset, detail::DataLengthSize);
-        if (reader.checksum() != checksum)
+        crc32c_t crc = update_crc32c_checksum(origin, data, chunk_size);
+        for (size_t i = spawned; i < chunks; ++i)
         {
-            result.code = ResultCode::ChecksumIncorrect;
-            return result;
+            const size_t begin = i * chunk_size;
+            const size_t length = (i + 1 == chunks) ? size - begin : chunk_size;
+            partial[i] = update_crc32c_checksum(Initial_CRC32C, data + begin, length);
         }
 
-        // data
-        reader >> object;
-        const ResultCode result_code = reader.result();
-        if (result_code != ResultCode::OK)
+        for (auto& worker : workers)
         {
-            result.code = result_code;
-            return result;
+            worker.join();
         }
 
-        return result;
+        for (size_t i = 1; i < chunks; ++i)
+        {
+            const size_t begin = i * chunk_size;
+            const size_t length = (i + 1 == chunks) ? size - begin : chunk_size;
+            crc = crc32c_combine(crc, partial[i], length);
+        }
+        return crc;
     }
-}
 
-#pragma endregion HPP
+    namespace detail
+    {
+        void check_chunks(
+            const ChunkInfo* chunks,
+            size_t count,
+            uint8_t* corrupt,
+            unsigned threads
+        ) noexcept
+        {
+            const auto check_range = [chunks, corrupt](size_t begin, size_t end) noexcept {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const crc32c_t crc = update_crc32c_checksum(Initial_CRC32C, chunks[i].data, chunks[i].size);
+                    corrupt[i] = crc != chunks[i].checksum ? 1 : 0;
+                }
+            };
+
+            size_t total = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                total += chunks[i].size;
+            }
+
+            if (threads == 0)
+            {
+                threads = std::thread::hardware_concurrency();
+            }
+            // 与不分块时相同: 数据量没有超过ParallelChecksumThreshold时只使用当前线程
+            const size_t groups = total < ParallelChecksumThreshold ? 1 : std::min<size_t>(threads, count);
+            if (groups <= 1)
+            {
+                check_range(0, count);
+                return;
+            }
 
+            // 按块的数量平均分组，第0组由当前线程校验
+            const size_t group_size = count / groups;
+            std::vector<std::thread> workers{};
+            size_t spawned = 1;
 
+            try
+            {
+                workers.reserve(groups - 1);
+                for (; spawned < groups; ++spawned)
+                {
+                    const size_t begin = spawned * group_size;
+                    const size_t end = (spawned + 1 == groups) ? count : begin + group_size;
+                    workers.emplace_back(check_range, begin, end);
+                }
+            }
+            catch (...)
+            {
+                // 创建线程失败: 剩下的组由当前线程校验
+            }
 
-#pragma region CPP
-#ifdef INFRA_BINARY_SERIALIZATION_IMPL
+            check_range(0, group_size);
+            if (spawned < groups)
+            {
+                check_range(spawned * group_size, count);
+            }
 
-#if INFRA_ARCH_X86
-    #if defined(_MSC_VER)
-        #include <intrin.h>
-    #else
-        #include <cpuid.h>
-    #endif
-    #include <nmmintrin.h>
-#elif INFRA_ARCH_ARM
-    #include <arm_acle.h>
-#endif
+            for (auto& worker : workers)
+            {
+                worker.join();
+            }
+        }
+    }
 
-namespace infra::binary_serialization
-{
     namespace detail
     {
 #if INFRA_ARCH_X86
@@ -793,6 +3302,314 @@ namespace infra::binary_serialization
         }
 #endif
 
+#if INFRA_ARCH_X86_64
+        // GF(2)上的32x32矩阵，用于构造"在crc后追加len个0字节"的线性变换
+        using crc32c_gf2_matrix_t = std::array<crc32c_t, 32>;
+
+        consteval crc32c_t crc32c_gf2_matrix_times(const crc32c_gf2_matrix_t& mat, crc32c_t vec)
+        {
+            crc32c_t sum = 0;
+            for (size_t i = 0; vec != 0; ++i, vec >>= 1)
+            {
+                if (vec & 1)
+                    sum ^= mat[i];
+            }
+            return sum;
+        }
+
+        consteval crc32c_gf2_matrix_t crc32c_gf2_matrix_square(const crc32c_gf2_matrix_t& mat)
+        {
+            crc32c_gf2_matrix_t square{};
+            for (size_t i = 0; i < 32; ++i)
+            {
+                square[i] = crc32c_gf2_matrix_times(mat, mat[i]);
+            }
+            return square;
+        }
+
+        // 追加len(2的幂)个0字节的变换，按crc的4个字节拆成4张查找表
+        consteval std::array<std::array<crc32c_t, 256>, 4> make_crc32c_zeros_table(size_t len)
+        {
+            // 1个0比特
+            crc32c_gf2_matrix_t op{};
+            op[0] = 0x82F63B78;
+            for (size_t i = 1; i < 32; ++i)
+            {
+                op[i] = crc32c_t{ 1 } << (i - 1);
+            }
+
+            // 1个0字节 = 8个0比特，之后每次平方长度翻倍
+            for (int i = 0; i < 3; ++i)
+            {
+                op = crc32c_gf2_matrix_square(op);
+            }
+            for (; len > 1; len >>= 1)
+            {
+                op = crc32c_gf2_matrix_square(op);
+            }
+
+            std::array<std::array<crc32c_t, 256>, 4> table{};
+            for (crc32c_t n = 0; n < 256; ++n)
+            {
+                for (size_t k = 0; k < 4; ++k)
+                {
+                    table[k][n] = crc32c_gf2_matrix_times(op, n << (8 * k));
+                }
+            }
+            return table;
+        }
+
+        // 每路的块大小，必须是2的幂并且是8的倍数
+        static constexpr size_t Crc32cLongBlock = 8192;
+        static constexpr size_t Crc32cShortBlock = 256;
+
+        static constexpr auto crc32c_long_zeros = make_crc32c_zeros_table(Crc32cLongBlock);
+        static constexpr auto crc32c_short_zeros = make_crc32c_zeros_table(Crc32cShortBlock);
+
+        static inline crc32c_t crc32c_shift(const std::array<std::array<crc32c_t, 256>, 4>& zeros, crc32c_t crc) noexcept
+        {
+            return zeros[0][crc & 0xff] ^ zeros[1][(crc >> 8) & 0xff] ^ zeros[2][(crc >> 16) & 0xff] ^ zeros[3][crc >> 24];
+        }
+
+        // 3路独立的crc32依赖链并行计算，结束后通过"追加0字节"的变换合并: crc(A|B) = shift(crc(A), |B|) ^ crc0(B)
+        template<size_t Block>
+        INFRA_FUNC_ATTR_INTRINSICS_SSE4_2
+        static inline uint64_t crc32c_3way_blocks(
+            uint64_t crc0,
+            const uint8_t*& data,
+            size_t& size,
+            const std::array<std::array<crc32c_t, 256>, 4>& zeros
+        ) noexcept
+        {
+            while (size >= Block * 3)
+            {
+                uint64_t crc1 = 0;
+                uint64_t crc2 = 0;
+                for (size_t i = 0; i < Block; i += 8)
+                {
+                    uint64_t v0;
+                    uint64_t v1;
+                    uint64_t v2;
+                    std::memcpy(&v0, data + i, sizeof(uint64_t));
+                    std::memcpy(&v1, data + Block + i, sizeof(uint64_t));
+                    std::memcpy(&v2, data + Block * 2 + i, sizeof(uint64_t));
+                    crc0 = _mm_crc32_u64(crc0, v0);
+                    crc1 = _mm_crc32_u64(crc1, v1);
+                    crc2 = _mm_crc32_u64(crc2, v2);
+                }
+                crc0 = crc32c_shift(zeros, static_cast<crc32c_t>(crc0)) ^ crc1;
+                crc0 = crc32c_shift(zeros, static_cast<crc32c_t>(crc0)) ^ crc2;
+
+                data += Block * 3;
+                size -= Block * 3;
+            }
+            return crc0;
+        }
+
+        crc32c_t update_crc32c_checksum_x86_3way(
+            crc32c_t origin,
+            const uint8_t* data,
+            size_t size
+        ) noexcept
+        {
+            uint64_t crc = origin ^ 0xffffffffu;
+
+            crc = crc32c_3way_blocks<Crc32cLongBlock>(crc, data, size, crc32c_long_zeros);
+            crc = crc32c_3way_blocks<Crc32cShortBlock>(crc, data, size, crc32c_short_zeros);
+
+            // 剩余不足3个短块的数据走单路
+            return update_crc32c_checksum_x86(static_cast<crc32c_t>(crc) ^ 0xffffffffu, data, size);
+        }
+
+        // 反射表示下的 x^n mod P: 第i位对应x^(31-i)
+        consteval crc32c_t crc32c_xpow_mod(size_t n)
+        {
+            crc32c_t v = 0x80000000u; // x^0
+            for (size_t i = 0; i < n; ++i)
+            {
+                v = (v >> 1) ^ ((v & 1) ? 0x82F63B78u : 0u);
+            }
+            return v;
+        }
+
+        // 把16字节块向后移动bytes字节所需的两个乘数
+        // 64位 x 32位的carry-less乘积在反射表示下相当于多乘了x^33，所以常量是 x^(E-33)
+        // lo: 块的低8字节(高次项)，需要乘 x^(8*bytes+64)；hi: 块的高8字节，需要乘 x^(8*bytes)
+        struct Crc32cFoldConstant
+        {
+            uint64_t lo;
+            uint64_t hi;
+        };
+
+        consteval Crc32cFoldConstant make_crc32c_fold_constant(size_t bytes)
+        {
+            return { crc32c_xpow_mod(8 * bytes + 64 - 33), crc32c_xpow_mod(8 * bytes - 33) };
+        }
+
+        static constexpr Crc32cFoldConstant crc32c_fold_k16 = make_crc32c_fold_constant(16);
+        static constexpr Crc32cFoldConstant crc32c_fold_k32 = make_crc32c_fold_constant(32);
+        static constexpr Crc32cFoldConstant crc32c_fold_k48 = make_crc32c_fold_constant(48);
+        static constexpr Crc32cFoldConstant crc32c_fold_k64 = make_crc32c_fold_constant(64);
+        static constexpr Crc32cFoldConstant crc32c_fold_k128 = make_crc32c_fold_constant(128);
+        static constexpr Crc32cFoldConstant crc32c_fold_k192 = make_crc32c_fold_constant(192);
+        static constexpr Crc32cFoldConstant crc32c_fold_k256 = make_crc32c_fold_constant(256);
+
+        // 低于这个长度时折叠的准备和收尾开销不划算
+        static constexpr size_t Crc32cPclmulMinSize = 256;
+        static constexpr size_t Crc32cVpclmulMinSize = 1024;
+
+        INFRA_FUNC_ATTR_INTRINSICS_SSE4_2 INFRA_FUNC_ATTR_INTRINSICS_PCLMUL
+        static inline __m128i crc32c_fold_constant_128(const Crc32cFoldConstant& k) noexcept
+        {
+            return _mm_set_epi64x(static_cast<long long>(k.hi), static_cast<long long>(k.lo));
+        }
+
+        // acc * x^(8*bytes) ^ next
+        INFRA_FUNC_ATTR_INTRINSICS_SSE4_2 INFRA_FUNC_ATTR_INTRINSICS_PCLMUL
+        static inline __m128i crc32c_fold_128(__m128i acc, __m128i k, __m128i next) noexcept
+        {
+            return _mm_xor_si128(
+                _mm_xor_si128(_mm_clmulepi64_si128(acc, k, 0x00), _mm_clmulepi64_si128(acc, k, 0x11)),
+                next
+            );
+        }
+
+        INFRA_FUNC_ATTR_INTRINSICS_SSE4_2 INFRA_FUNC_ATTR_INTRINSICS_PCLMUL
+        static inline __m128i crc32c_load_128(const uint8_t* data) noexcept
+        {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        }
+
+        // 把4个相邻的16字节累加器合并为1个，继续按16字节折叠，最后用crc32指令归约到32位并处理尾部
+        INFRA_FUNC_ATTR_INTRINSICS_SSE4_2 INFRA_FUNC_ATTR_INTRINSICS_PCLMUL
+        static inline crc32c_t crc32c_fold_finish(
+            __m128i x0,
+            __m128i x1,
+            __m128i x2,
+            __m128i x3,
+            const uint8_t* data,
+            size_t size
+        ) noexcept
+        {
+            __m128i x = crc32c_fold_128(x0, crc32c_fold_constant_128(crc32c_fold_k48), x3);
+            x = crc32c_fold_128(x1, crc32c_fold_constant_128(crc32c_fold_k32), x);
+            x = crc32c_fold_128(x2, crc32c_fold_constant_128(crc32c_fold_k16), x);
+
+            const __m128i k16 = crc32c_fold_constant_128(crc32c_fold_k16);
+            for (; size >= 16; data += 16, size -= 16)
+            {
+                x = crc32c_fold_128(x, k16, crc32c_load_128(data));
+            }
+
+            // crc(x) = x * x^32 mod P，等价于从0开始依次对两个8字节执行crc32指令
+            uint64_t crc = _mm_crc32_u64(0, static_cast<uint64_t>(_mm_cvtsi128_si64(x)));
+            crc = _mm_crc32_u64(crc, static_cast<uint64_t>(_mm_extract_epi64(x, 1)));
+
+            return update_crc32c_checksum_x86(static_cast<crc32c_t>(crc) ^ 0xffffffffu, data, size);
+        }
+
+        crc32c_t update_crc32c_checksum_x86_pclmul(
+            crc32c_t origin,
+            const uint8_t* data,
+            size_t size
+        ) noexcept
+        {
+            if (size < Crc32cPclmulMinSize)
+                return update_crc32c_checksum_x86_3way(origin, data, size);
+
+            // 初始crc异或到第一个块的前4字节上
+            const crc32c_t crc = origin ^ 0xffffffffu;
+            __m128i x0 = _mm_xor_si128(crc32c_load_128(data), _mm_cvtsi32_si128(static_cast<int>(crc)));
+            __m128i x1 = crc32c_load_128(data + 16);
+            __m128i x2 = crc32c_load_128(data + 32);
+            __m128i x3 = crc32c_load_128(data + 48);
+            data += 64;
+            size -= 64;
+
+            const __m128i k64 = crc32c_fold_constant_128(crc32c_fold_k64);
+            for (; size >= 64; data += 64, size -= 64)
+            {
+                x0 = crc32c_fold_128(x0, k64, crc32c_load_128(data));
+                x1 = crc32c_fold_128(x1, k64, crc32c_load_128(data + 16));
+                x2 = crc32c_fold_128(x2, k64, crc32c_load_128(data + 32));
+                x3 = crc32c_fold_128(x3, k64, crc32c_load_128(data + 48));
+            }
+
+            return crc32c_fold_finish(x0, x1, x2, x3, data, size);
+        }
+
+        INFRA_FUNC_ATTR_INTRINSICS_AVX512_F INFRA_FUNC_ATTR_INTRINSICS_PCLMUL INFRA_FUNC_ATTR_INTRINSICS_VPCLMUL
+        static inline __m512i crc32c_fold_512(__m512i acc, __m512i k, __m512i next) noexcept
+        {
+            return _mm512_ternarylogic_epi64(
+                _mm512_clmulepi64_epi128(acc, k, 0x00),
+                _mm512_clmulepi64_epi128(acc, k, 0x11),
+                next,
+                0x96 // a ^ b ^ c
+            );
+        }
+
+        INFRA_FUNC_ATTR_INTRINSICS_AVX512_F INFRA_FUNC_ATTR_INTRINSICS_PCLMUL INFRA_FUNC_ATTR_INTRINSICS_VPCLMUL
+        static inline __m512i crc32c_fold_constant_512(const Crc32cFoldConstant& k) noexcept
+        {
+            const auto lo = static_cast<long long>(k.lo);
+            const auto hi = static_cast<long long>(k.hi);
+            return _mm512_set_epi64(hi, lo, hi, lo, hi, lo, hi, lo);
+        }
+
+        crc32c_t update_crc32c_checksum_x86_vpclmul(
+            crc32c_t origin,
+            const uint8_t* data,
+            size_t size
+        ) noexcept
+        {
+            if (size < Crc32cVpclmulMinSize)
+                return update_crc32c_checksum_x86_pclmul(origin, data, size);
+
+            const crc32c_t crc = origin ^ 0xffffffffu;
+            const __m512i init = _mm512_set_epi64(0, 0, 0, 0, 0, 0, 0, static_cast<long long>(crc));
+            __m512i z0 = _mm512_xor_si512(_mm512_loadu_si512(data), init);
+            __m512i z1 = _mm512_loadu_si512(data + 64);
+            __m512i z2 = _mm512_loadu_si512(data + 128);
+            __m512i z3 = _mm512_loadu_si512(data + 192);
+            data += 256;
+            size -= 256;
+
+            const __m512i k256 = crc32c_fold_constant_512(crc32c_fold_k256);
+            for (; size >= 256; data += 256, size -= 256)
+            {
+                z0 = crc32c_fold_512(z0, k256, _mm512_loadu_si512(data));
+                z1 = crc32c_fold_512(z1, k256, _mm512_loadu_si512(data + 64));
+                z2 = crc32c_fold_512(z2, k256, _mm512_loadu_si512(data + 128));
+                z3 = crc32c_fold_512(z3, k256, _mm512_loadu_si512(data + 192));
+            }
+
+            // 4个512位累加器合并为1个
+            __m512i z = crc32c_fold_512(z0, crc32c_fold_constant_512(crc32c_fold_k192), z3);
+            z = crc32c_fold_512(z1, crc32c_fold_constant_512(crc32c_fold_k128), z);
+            z = crc32c_fold_512(z2, crc32c_fold_constant_512(crc32c_fold_k64), z);
+
+            const __m512i k64 = crc32c_fold_constant_512(crc32c_fold_k64);
+            for (; size >= 64; data += 64, size -= 64)
+            {
+                z = crc32c_fold_512(z, k64, _mm512_loadu_si512(data));
+            }
+
+            // 拆成4个相邻的16字节块，只在收尾执行一次，直接经过内存
+            alignas(64) uint8_t lanes[64];
+            _mm512_store_si512(lanes, z);
+
+            return crc32c_fold_finish(
+                crc32c_load_128(lanes),
+                crc32c_load_128(lanes + 16),
+                crc32c_load_128(lanes + 32),
+                crc32c_load_128(lanes + 48),
+                data,
+                size
+            );
+        }
+#endif
+
 #if INFRA_ARCH_ARM
         crc32c_t update_crc32c_checksum_arm(
             crc32c_t origin,
@@ -856,6 +3673,329 @@ namespace infra::binary_serialization
             static bool result = support_crc32_intrinsic_impl();
             return result;
         }
+
+        static Crc32cKernel crc32c_kernel_impl() noexcept
+        {
+            if (!support_crc32_intrinsic())
+                return Crc32cKernel::Scalar;
+
+        #if INFRA_ARCH_X86_64
+            uint32_t abcd[4]{};
+            cpuid(0, 0, abcd);
+            const uint32_t max_leaf = abcd[0];
+
+            cpuid(1, 0, abcd);
+            const uint32_t ecx1 = abcd[2];
+            // PCLMULQDQ: EAX 1, ECX 1
+            if ((ecx1 & (1u << 1)) == 0)
+                return Crc32cKernel::Instruction;
+
+            // OSXSAVE: EAX 1, ECX 27，之后才能用xgetbv确认系统保存了zmm寄存器
+            if (max_leaf >= 7 && (ecx1 & (1u << 27)) != 0)
+            {
+                cpuid(7, 0, abcd);
+                const uint32_t ebx7 = abcd[1];
+                const uint32_t ecx7 = abcd[2];
+
+            #if defined(_MSC_VER)
+                const uint64_t xcr0 = _xgetbv(0);
+            #else
+                uint32_t eax;
+                uint32_t edx;
+                __asm__ __volatile__ ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+                const uint64_t xcr0 = (static_cast<uint64_t>(edx) << 32) | eax;
+            #endif
+
+                // XCR0: SSE(1) AVX(2) opmask(5) ZMM_Hi256(6) Hi16_ZMM(7)
+                const bool os_support_avx_512 = (xcr0 & 0xE6) == 0xE6;
+                // AVX-512F: EAX 7, EBX 16; VPCLMULQDQ: EAX 7, ECX 10
+                if (os_support_avx_512 && (ebx7 & (1u << 16)) != 0 && (ecx7 & (1u << 10)) != 0)
+                    return Crc32cKernel::Vpclmul;
+            }
+
+            return Crc32cKernel::Pclmul;
+        #else
+            return Crc32cKernel::Instruction;
+        #endif
+        }
+
+        Crc32cKernel crc32c_kernel() noexcept
+        {
+            static Crc32cKernel result = crc32c_kernel_impl();
+            return result;
+        }
+
+    #if INFRA_ARCH_X86_64
+        INFRA_FUNC_ATTR_INTRINSICS_BMI2 size_t decode_varint_bmi2(const uint8_t* src, size_t available, uint64_t& out) noexcept
+        {
+            uint64_t word;
+            memcpy(&word, src, sizeof(word));
+
+            // 每个字节的最高位为0的位置就是结束字节
+            const uint64_t stops = ~word & 0x8080808080808080ull;
+            if (stops == 0)
+            {
+                // 9、10字节的varint很少见
+                return decode_varint_scalar(src, available, out);
+            }
+
+            const size_t length = static_cast<size_t>(std::countr_zero(stops) >> 3) + 1;
+            const uint64_t mask = length == 8 ? ~0ull : (1ull << (length * 8)) - 1;
+            out = _pext_u64(word & mask, 0x7f7f7f7f7f7f7f7full);
+            return length;
+        }
+    #else
+        size_t decode_varint_bmi2(const uint8_t* src, size_t available, uint64_t& out) noexcept
+        {
+            return decode_varint_scalar(src, available, out);
+        }
+    #endif
+
+        static bool support_fast_pext_impl() noexcept
+        {
+        #if INFRA_ARCH_X86_64
+            uint32_t abcd[4]{};
+            cpuid(0, 0, abcd);
+            const uint32_t max_leaf = abcd[0];
+            // "AuthenticAMD"
+            const bool amd = abcd[1] == 0x68747541 && abcd[3] == 0x69746e65 && abcd[2] == 0x444d4163;
+            if (max_leaf < 7)
+                return false;
+
+            if (amd)
+            {
+                // family = base family + extended family，Zen3为0x19
+                cpuid(1, 0, abcd);
+                const uint32_t family = ((abcd[0] >> 8) & 0xf) + ((abcd[0] >> 20) & 0xff);
+                if (family < 0x19)
+                    return false;
+            }
+
+            // BMI2: EAX 7, EBX 8
+            cpuid(7, 0, abcd);
+            return (abcd[1] & (1u << 8)) != 0;
+        #else
+            return false;
+        #endif
+        }
+
+        bool support_fast_pext() noexcept
+        {
+            static bool result = support_fast_pext_impl();
+            return result;
+        }
+
+        // LZ4 block格式: 每个sequence由token(高4位literal长度，低4位match长度-4)、literal、2字节offset组成
+        // 长度为15时后面跟着若干扩展字节(累加，直到不为255); 最后一个sequence只有literal
+        INFRA_HEADER_GLOBAL_CONSTEXPR size_t Lz4MinMatch = 4;
+        INFRA_HEADER_GLOBAL_CONSTEXPR size_t Lz4MfLimit = 12;       // 最后一个match的起点距离结尾至少12字节
+        INFRA_HEADER_GLOBAL_CONSTEXPR size_t Lz4LastLiterals = 5;   // 最后5个字节必须是literal
+        INFRA_HEADER_GLOBAL_CONSTEXPR size_t Lz4MaxDistance = 65535;
+        INFRA_HEADER_GLOBAL_CONSTEXPR int Lz4HashLog = 12;
+
+        static uint32_t lz4_read32(const uint8_t* p) noexcept
+        {
+            uint32_t v;
+            memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        static uint32_t lz4_hash(uint32_t v) noexcept
+        {
+            return (v * 2654435761u) >> (32 - Lz4HashLog);
+        }
+
+        static uint8_t* lz4_write_length(uint8_t* op, size_t length) noexcept
+        {
+            while (length >= 255)
+            {
+                *op++ = 255;
+                length -= 255;
+            }
+            *op++ = static_cast<uint8_t>(length);
+            return op;
+        }
+
+        // match_length为0表示最后一个只有literal的sequence; 空间不足时返回nullptr
+        static uint8_t* lz4_write_sequence(
+            uint8_t* op, const uint8_t* oend,
+            const uint8_t* literal, size_t literal_length,
+            size_t match_length, size_t offset
+        ) noexcept
+        {
+            // token + literal长度扩展 + literal + offset + match长度扩展
+            const size_t need = 1 + (literal_length / 255 + 1) + literal_length + 2 + (match_length / 255 + 1);
+            if (static_cast<size_t>(oend - op) < need)
+                return nullptr;
+
+            const size_t match_code = match_length == 0 ? 0 : match_length - Lz4MinMatch;
+            *op++ = static_cast<uint8_t>(((literal_length < 15 ? literal_length : 15) << 4) | (match_code < 15 ? match_code : 15));
+            if (literal_length >= 15)
+            {
+                op = lz4_write_length(op, literal_length - 15);
+            }
+
+            if (literal_length != 0)
+            {
+                memcpy(op, literal, literal_length);
+                op += literal_length;
+            }
+
+            if (match_length == 0)
+                return op;
+
+            *op++ = static_cast<uint8_t>(offset);
+            *op++ = static_cast<uint8_t>(offset >> 8);
+            if (match_code >= 15)
+            {
+                op = lz4_write_length(op, match_code - 15);
+            }
+            return op;
+        }
+
+        size_t lz4_compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity) noexcept
+        {
+            uint8_t* op = dst;
+            const uint8_t* const oend = dst + capacity;
+            const uint8_t* anchor = src;
+            const uint8_t* const iend = src + size;
+
+            // 太短的输入全部作为literal
+            if (size > Lz4MfLimit)
+            {
+                const uint8_t* table[1u << Lz4HashLog];
+                for (auto& entry : table)
+                {
+                    entry = src;
+                }
+
+                const uint8_t* const match_limit = iend - Lz4LastLiterals;
+                const uint8_t* const ip_limit = iend - Lz4MfLimit;
+                const uint8_t* ip = src + 1;
+                while (ip <= ip_limit)
+                {
+                    const uint32_t sequence = lz4_read32(ip);
+                    const uint32_t h = lz4_hash(sequence);
+                    const uint8_t* ref = table[h];
+                    table[h] = ip;
+
+                    if (ref >= ip || static_cast<size_t>(ip - ref) > Lz4MaxDistance || lz4_read32(ref) != sequence)
+                    {
+                        // 长时间找不到匹配时加大步长，不可压缩的数据接近memcpy的速度
+                        ip += 1 + (static_cast<size_t>(ip - anchor) >> 6);
+                        continue;
+                    }
+
+                    // 向前、向后扩展匹配
+                    while (ip > anchor && ref > src && ip[-1] == ref[-1])
+                    {
+                        --ip;
+                        --ref;
+                    }
+                    const uint8_t* match_end = ip + Lz4MinMatch;
+                    const uint8_t* ref_end = ref + Lz4MinMatch;
+                    while (match_end < match_limit && *match_end == *ref_end)
+                    {
+                        ++match_end;
+                        ++ref_end;
+                    }
+
+                    op = lz4_write_sequence(op, oend, anchor, static_cast<size_t>(ip - anchor),
+                        static_cast<size_t>(match_end - ip), static_cast<size_t>(ip - ref));
+                    if (op == nullptr)
+                        return 0;
+
+                    ip = match_end;
+                    anchor = ip;
+                    table[lz4_hash(lz4_read32(ip - 2))] = ip - 2;
+                }
+            }
+
+            op = lz4_write_sequence(op, oend, anchor, static_cast<size_t>(iend - anchor), 0, 0);
+            if (op == nullptr)
+                return 0;
+
+            return static_cast<size_t>(op - dst);
+        }
+
+        static bool lz4_read_length(const uint8_t*& ip, const uint8_t* iend, size_t& length) noexcept
+        {
+            uint8_t b;
+            do
+            {
+                if (ip >= iend)
+                    return false;
+
+                b = *ip++;
+                length += b;
+            } while (b == 255);
+            return true;
+        }
+
+        bool lz4_decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t dst_size) noexcept
+        {
+            const uint8_t* ip = src;
+            const uint8_t* const iend = src + size;
+            uint8_t* op = dst;
+            uint8_t* const oend = dst + dst_size;
+
+            while (true)
+            {
+                if (ip >= iend)
+                    return false;
+
+                const uint8_t token = *ip++;
+
+                // literal
+                size_t literal_length = token >> 4;
+                if (literal_length == 15 && !lz4_read_length(ip, iend, literal_length))
+                    return false;
+                if (literal_length > static_cast<size_t>(iend - ip) || literal_length > static_cast<size_t>(oend - op))
+                    return false;
+
+                if (literal_length != 0)
+                {
+                    memcpy(op, ip, literal_length);
+                    ip += literal_length;
+                    op += literal_length;
+                }
+
+                // 最后一个sequence
+                if (ip == iend)
+                    return op == oend;
+
+                // match
+                if (iend - ip < 2)
+                    return false;
+
+                const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+                ip += 2;
+                if (offset == 0 || offset > static_cast<size_t>(op - dst))
+                    return false;
+
+                size_t match_length = token & 15;
+                if (match_length == 15 && !lz4_read_length(ip, iend, match_length))
+                    return false;
+                match_length += Lz4MinMatch;
+                if (match_length > static_cast<size_t>(oend - op))
+                    return false;
+
+                const uint8_t* match = op - offset;
+                if (offset >= match_length)
+                {
+                    memcpy(op, match, match_length);
+                    op += match_length;
+                }
+                else
+                {
+                    // 重叠的match用来表示重复的模式，只能逐字节复制
+                    for (size_t i = 0; i < match_length; ++i)
+                    {
+                        *op++ = *match++;
+                    }
+                }
+            }
+        }
     }
 } // namespace infra::binary_serialization
 
@@ -0,0 +1,520 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include <utility>
+
+#include "infra/binary_serialization.cpp.hpp"
+#include "infra/detail/os_detect.hpp"
+
+#if INFRA_OS_WINDOWS
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <cerrno>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace infra::binary_serialization
+{
+    // 只读方式映射整个文件，deserialize直接从page cache读取，不需要先把文件复制到std::vector
+    // 只能用于Reader
+    class MappedFile
+    {
+    public:
+        MappedFile() noexcept = default;
+
+        ~MappedFile() noexcept
+        {
+            close();
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept
+            : m_data(std::exchange(other.m_data, nullptr))
+            , m_size(std::exchange(other.m_size, 0))
+        #if INFRA_OS_WINDOWS
+            , m_mapping(std::exchange(other.m_mapping, nullptr))
+        #endif
+        {
+        }
+
+        MappedFile& operator=(MappedFile&& other) noexcept
+        {
+            if (this != &other)
+            {
+                close();
+                m_data = std::exchange(other.m_data, nullptr);
+                m_size = std::exchange(other.m_size, 0);
+            #if INFRA_OS_WINDOWS
+                m_mapping = std::exchange(other.m_mapping, nullptr);
+            #endif
+            }
+            return *this;
+        }
+
+        // 映射成功返回true，空文件也会成功(size为0)
+        // 映射后按顺序预读，反序列化基本是从头到尾的顺序访问
+        bool open(const char* path) noexcept
+        {
+            close();
+
+        #if INFRA_OS_WINDOWS
+            HANDLE file = ::CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                return false;
+
+            LARGE_INTEGER file_size{};
+            if (!::GetFileSizeEx(file, &file_size))
+            {
+                ::CloseHandle(file);
+                return false;
+            }
+
+            if (file_size.QuadPart == 0)
+            {
+                ::CloseHandle(file);
+                return true;
+            }
+
+            m_mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            ::CloseHandle(file);
+            if (m_mapping == nullptr)
+                return false;
+
+            void* addr = ::MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+            if (addr == nullptr)
+            {
+                ::CloseHandle(m_mapping);
+                m_mapping = nullptr;
+                return false;
+            }
+
+            m_data = static_cast<const uint8_t*>(addr);
+            m_size = static_cast<size_t>(file_size.QuadPart);
+            return true;
+        #else
+            const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                return false;
+
+            struct stat st{};
+            if (::fstat(fd, &st) != 0)
+            {
+                ::close(fd);
+                return false;
+            }
+
+            if (st.st_size == 0)
+            {
+                ::close(fd);
+                return true;
+            }
+
+            const size_t size = static_cast<size_t>(st.st_size);
+            void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd); // 映射建立后不再需要fd
+            if (addr == MAP_FAILED)
+                return false;
+
+            ::madvise(addr, size, MADV_SEQUENTIAL);
+            ::madvise(addr, size, MADV_WILLNEED);
+
+            m_data = static_cast<const uint8_t*>(addr);
+            m_size = size;
+            return true;
+        #endif
+        }
+
+        void close() noexcept
+        {
+            if (m_data != nullptr)
+            {
+            #if INFRA_OS_WINDOWS
+                ::UnmapViewOfFile(m_data);
+            #else
+                ::munmap(const_cast<uint8_t*>(m_data), m_size);
+            #endif
+            }
+
+        #if INFRA_OS_WINDOWS
+            if (m_mapping != nullptr)
+            {
+                ::CloseHandle(m_mapping);
+                m_mapping = nullptr;
+            }
+        #endif
+
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+        [[nodiscard]] const uint8_t* data() const noexcept
+        {
+            return m_data;
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+    #if INFRA_OS_WINDOWS
+        HANDLE m_mapping = nullptr;
+    #endif
+    };
+
+    // 只读，只提供Reader需要的接口
+    template<>
+    struct Adaptor<MappedFile>
+    {
+        using byte_type = uint8_t;
+
+        static constexpr bool resizeable() noexcept
+        {
+            return false;
+        }
+
+        static size_t size(const MappedFile& file) noexcept
+        {
+            return file.size();
+        }
+
+        static const uint8_t* data(const MappedFile& file) noexcept
+        {
+            return file.data();
+        }
+    };
+
+    // 可增长的文件映射，serialize直接写入page cache，省掉std::vector到write()的复制
+    // 容量不足时按几何级数扩大文件并重新映射，close时把文件截断到实际大小
+    // 扩大文件时预先分配磁盘空间(posix_fallocate)，磁盘已满时reserve失败，Writer报告IncompleteSerialization;
+    // 不支持预分配的文件系统(以及macOS)退回ftruncate，得到的是稀疏文件，写入时磁盘已满会触发SIGBUS
+    // 注意: 重新映射后data()的地址会变化
+    class MappedFileWriter
+    {
+    public:
+        static constexpr size_t MinGrowBytes = 1024 * 1024;
+
+        MappedFileWriter() noexcept = default;
+
+        ~MappedFileWriter() noexcept
+        {
+            close();
+        }
+
+        MappedFileWriter(const MappedFileWriter&) = delete;
+        MappedFileWriter& operator=(const MappedFileWriter&) = delete;
+
+        MappedFileWriter(MappedFileWriter&& other) noexcept
+            : m_data(std::exchange(other.m_data, nullptr))
+            , m_size(std::exchange(other.m_size, 0))
+            , m_capacity(std::exchange(other.m_capacity, 0))
+        #if INFRA_OS_WINDOWS
+            , m_file(std::exchange(other.m_file, nullptr))
+            , m_mapping(std::exchange(other.m_mapping, nullptr))
+        #else
+            , m_fd(std::exchange(other.m_fd, -1))
+        #endif
+        {
+        }
+
+        MappedFileWriter& operator=(MappedFileWriter&& other) noexcept
+        {
+            if (this != &other)
+            {
+                close();
+                m_data = std::exchange(other.m_data, nullptr);
+                m_size = std::exchange(other.m_size, 0);
+                m_capacity = std::exchange(other.m_capacity, 0);
+            #if INFRA_OS_WINDOWS
+                m_file = std::exchange(other.m_file, nullptr);
+                m_mapping = std::exchange(other.m_mapping, nullptr);
+            #else
+                m_fd = std::exchange(other.m_fd, -1);
+            #endif
+            }
+            return *this;
+        }
+
+        // 创建(或清空)文件，成功返回true
+        bool open(const char* path) noexcept
+        {
+            close();
+
+        #if INFRA_OS_WINDOWS
+            m_file = ::CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE)
+            {
+                m_file = nullptr;
+                return false;
+            }
+        #else
+            m_fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (m_fd < 0)
+                return false;
+        #endif
+            return true;
+        }
+
+        [[nodiscard]] bool is_open() const noexcept
+        {
+        #if INFRA_OS_WINDOWS
+            return m_file != nullptr;
+        #else
+            return m_fd >= 0;
+        #endif
+        }
+
+        // 把已写入的数据刷到磁盘
+        bool sync() noexcept
+        {
+            if (m_data == nullptr)
+                return true;
+
+        #if INFRA_OS_WINDOWS
+            return ::FlushViewOfFile(m_data, m_size) && ::FlushFileBuffers(m_file);
+        #else
+            return ::msync(m_data, m_capacity, MS_SYNC) == 0;
+        #endif
+        }
+
+        // 解除映射，把文件截断到实际写入的大小
+        bool close() noexcept
+        {
+            if (!is_open())
+                return true;
+
+            unmap();
+
+            bool ok = true;
+        #if INFRA_OS_WINDOWS
+            LARGE_INTEGER size{};
+            size.QuadPart = static_cast<LONGLONG>(m_size);
+            ok = ::SetFilePointerEx(m_file, size, nullptr, FILE_BEGIN) && ::SetEndOfFile(m_file);
+            ::CloseHandle(m_file);
+            m_file = nullptr;
+        #else
+            ok = ::ftruncate(m_fd, static_cast<off_t>(m_size)) == 0;
+            ::close(m_fd);
+            m_fd = -1;
+        #endif
+
+            m_size = 0;
+            m_capacity = 0;
+            return ok;
+        }
+
+        // 保证容量不小于new_capacity，失败时容量不变
+        bool reserve(size_t new_capacity) noexcept
+        {
+            if (new_capacity <= m_capacity)
+                return true;
+            if (!is_open())
+                return false;
+
+            unmap();
+
+        #if INFRA_OS_WINDOWS
+            LARGE_INTEGER size{};
+            size.QuadPart = static_cast<LONGLONG>(new_capacity);
+            m_mapping = ::CreateFileMappingA(m_file, nullptr, PAGE_READWRITE, size.HighPart, size.LowPart, nullptr);
+            if (m_mapping != nullptr)
+            {
+                m_data = static_cast<uint8_t*>(::MapViewOfFile(m_mapping, FILE_MAP_WRITE, 0, 0, new_capacity));
+            }
+        #else
+            if (allocate(new_capacity))
+            {
+                void* addr = ::mmap(nullptr, new_capacity, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+                m_data = addr == MAP_FAILED ? nullptr : static_cast<uint8_t*>(addr);
+            }
+        #endif
+
+            if (m_data == nullptr)
+            {
+                // 扩容失败，恢复原来的映射
+                unmap();
+                remap(m_capacity);
+                return false;
+            }
+
+            m_capacity = new_capacity;
+            return true;
+        }
+
+        // 空间不足时扩容，失败时大小不变
+        bool resize(size_t new_size) noexcept
+        {
+            if (new_size > m_capacity)
+            {
+                size_t new_capacity = m_capacity * 2;
+                if (new_capacity < MinGrowBytes)
+                    new_capacity = MinGrowBytes;
+                if (new_capacity < new_size)
+                    new_capacity = new_size;
+
+                if (!reserve(new_capacity))
+                    return false;
+            }
+
+            // 新增部分来自扩展的文件，内容为0；缩小后再扩大的部分需要重新清零
+            if (new_size > m_size)
+            {
+                memset(m_data + m_size, 0, new_size - m_size);
+            }
+            m_size = new_size;
+            return true;
+        }
+
+        [[nodiscard]] uint8_t* data() noexcept
+        {
+            return m_data;
+        }
+
+        [[nodiscard]] const uint8_t* data() const noexcept
+        {
+            return m_data;
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+        [[nodiscard]] size_t capacity() const noexcept
+        {
+            return m_capacity;
+        }
+
+    private:
+    #if !INFRA_OS_WINDOWS
+        // 把文件扩大到size字节，尽量预先分配磁盘空间
+        bool allocate(size_t size) noexcept
+        {
+        #if INFRA_OS_LINUX
+            const int err = ::posix_fallocate(m_fd, static_cast<off_t>(m_capacity), static_cast<off_t>(size - m_capacity));
+            if (err == 0)
+                return true;
+            if (err != EOPNOTSUPP && err != EINVAL)
+                return false; // ENOSPC等
+        #endif
+            return ::ftruncate(m_fd, static_cast<off_t>(size)) == 0;
+        }
+    #endif
+
+        void unmap() noexcept
+        {
+        #if INFRA_OS_WINDOWS
+            if (m_data != nullptr)
+                ::UnmapViewOfFile(m_data);
+            if (m_mapping != nullptr)
+                ::CloseHandle(m_mapping);
+            m_mapping = nullptr;
+        #else
+            if (m_data != nullptr)
+                ::munmap(m_data, m_capacity);
+        #endif
+            m_data = nullptr;
+        }
+
+        void remap(size_t capacity) noexcept
+        {
+            if (capacity == 0)
+                return;
+
+        #if INFRA_OS_WINDOWS
+            LARGE_INTEGER size{};
+            size.QuadPart = static_cast<LONGLONG>(capacity);
+            m_mapping = ::CreateFileMappingA(m_file, nullptr, PAGE_READWRITE, size.HighPart, size.LowPart, nullptr);
+            if (m_mapping != nullptr)
+            {
+                m_data = static_cast<uint8_t*>(::MapViewOfFile(m_mapping, FILE_MAP_WRITE, 0, 0, capacity));
+            }
+        #else
+            void* addr = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+            m_data = addr == MAP_FAILED ? nullptr : static_cast<uint8_t*>(addr);
+        #endif
+
+            if (m_data == nullptr)
+            {
+                m_size = 0;
+                m_capacity = 0;
+            }
+        }
+
+        uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+        size_t m_capacity = 0;
+    #if INFRA_OS_WINDOWS
+        HANDLE m_file = nullptr;
+        HANDLE m_mapping = nullptr;
+    #else
+        int m_fd = -1;
+    #endif
+    };
+
+    template<>
+    struct Adaptor<MappedFileWriter>
+    {
+        using byte_type = uint8_t;
+
+        static constexpr bool resizeable() noexcept
+        {
+            return true;
+        }
+
+        static size_t size(const MappedFileWriter& file) noexcept
+        {
+            return file.size();
+        }
+
+        static uint8_t* data(MappedFileWriter& file) noexcept
+        {
+            return file.data();
+        }
+
+        static const uint8_t* data(const MappedFileWriter& file) noexcept
+        {
+            return file.data();
+        }
+
+        // 扩容失败时大小不变，Writer会报告IncompleteSerialization
+        static void resize(MappedFileWriter& file, size_t new_size) noexcept
+        {
+            (void)file.resize(new_size);
+        }
+
+        static void push_back(MappedFileWriter& file, const uint8_t& val) noexcept
+        {
+            const size_t pos = file.size();
+            if (file.resize(pos + 1))
+            {
+                file.data()[pos] = val;
+            }
+        }
+
+        static size_t capacity(const MappedFileWriter& file) noexcept
+        {
+            return file.capacity();
+        }
+
+        static void reserve(MappedFileWriter& file, size_t new_capacity) noexcept
+        {
+            (void)file.reserve(new_capacity);
+        }
+    };
+}
\ No newline at end of file
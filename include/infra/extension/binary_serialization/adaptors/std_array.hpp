@@ -40,5 +40,15 @@ namespace infra::binary_serialization
         {
             // do nothing
         }
+
+        static size_t capacity(const std::array<ByteType, N>& arr) noexcept
+        {
+            return arr.size();
+        }
+
+        static void reserve(std::array<ByteType, N>&, size_t) noexcept
+        {
+            // do nothing
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <span>
+
+#include "infra/binary_serialization.cpp.hpp"
+
+namespace infra::binary_serialization
+{
+    // 不持有内存，直接在调用者提供的缓冲区(收包缓冲区、ring buffer槽位、arena等)中序列化/反序列化
+    // 大小固定，写入超出范围时返回IncompleteSerialization，实际写入的字节数见Result::bytes
+    template<is_byte_type ByteType, size_t Extent>
+    struct Adaptor<std::span<ByteType, Extent>>
+    {
+        using byte_type = ByteType;
+
+        static constexpr bool resizeable() noexcept
+        {
+            return false;
+        }
+
+        static size_t size(const std::span<ByteType, Extent>& span) noexcept
+        {
+            return span.size();
+        }
+
+        static ByteType* data(std::span<ByteType, Extent>& span) noexcept
+        {
+            return span.data();
+        }
+
+        static const ByteType* data(const std::span<ByteType, Extent>& span) noexcept
+        {
+            return span.data();
+        }
+
+        static void resize(std::span<ByteType, Extent>&, size_t) noexcept
+        {
+            // do nothing
+        }
+
+        static void push_back(std::span<ByteType, Extent>&, const ByteType&) noexcept
+        {
+            // do nothing
+        }
+
+        static size_t capacity(const std::span<ByteType, Extent>& span) noexcept
+        {
+            return span.size();
+        }
+
+        static void reserve(std::span<ByteType, Extent>&, size_t) noexcept
+        {
+            // do nothing
+        }
+    };
+
+    // 只读，只提供Reader需要的接口
+    template<is_byte_type ByteType, size_t Extent>
+    struct Adaptor<std::span<const ByteType, Extent>>
+    {
+        using byte_type = ByteType;
+
+        static constexpr bool resizeable() noexcept
+        {
+            return false;
+        }
+
+        static size_t size(const std::span<const ByteType, Extent>& span) noexcept
+        {
+            return span.size();
+        }
+
+        static const ByteType* data(const std::span<const ByteType, Extent>& span) noexcept
+        {
+            return span.data();
+        }
+    };
+}
\ No newline at end of file
@@ -40,5 +40,15 @@ namespace infra::binary_serialization
         {
             vec.push_back(val);
         }
+
+        static size_t capacity(const std::vector<ByteType, Allocator>& vec) noexcept
+        {
+            return vec.capacity();
+        }
+
+        static void reserve(std::vector<ByteType, Allocator>& vec, size_t new_capacity) noexcept
+        {
+            vec.reserve(new_capacity);
+        }
     };
 }
\ No newline at end of file
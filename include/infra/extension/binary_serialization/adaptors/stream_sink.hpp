@@ -0,0 +1,260 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+
+#include <type_traits>
+#include <vector>
+
+#include "infra/binary_serialization.cpp.hpp"
+#include "infra/detail/os_detect.hpp"
+
+#if INFRA_OS_WINDOWS
+    #include <io.h>
+#else
+    #include <cerrno>
+    #include <unistd.h>
+#endif
+
+namespace infra::binary_serialization
+{
+    // 流式输出: Writer先写入固定大小的缓冲区，写满后整块输出，header中的data_length和checksum在结束时回填
+    // 内存占用只和chunk_size有关，与对象大小无关
+    // 同一个sink可以连续serialize多个对象，它们在文件中首尾相接
+    class StreamSinkBuffer
+    {
+    public:
+        static constexpr size_t DefaultChunkSize = 1024 * 1024;
+        static constexpr size_t MinChunkSize = 64;
+
+        explicit StreamSinkBuffer(size_t chunk_size)
+            : m_chunk_size(chunk_size < MinChunkSize ? MinChunkSize : chunk_size)
+        {
+            m_buffer.reserve(m_chunk_size);
+        }
+
+        [[nodiscard]] size_t chunk_size() const noexcept
+        {
+            return m_chunk_size;
+        }
+
+        // 已经输出的字节数
+        [[nodiscard]] size_t written() const noexcept
+        {
+            return m_written;
+        }
+
+        std::vector<uint8_t>& buffer() noexcept
+        {
+            return m_buffer;
+        }
+
+        const std::vector<uint8_t>& buffer() const noexcept
+        {
+            return m_buffer;
+        }
+
+    protected:
+        std::vector<uint8_t> m_buffer;
+        size_t m_chunk_size;
+        size_t m_written = 0;
+    };
+
+    // 输出到文件描述符，回填header需要fd支持随机写入(pipe、socket不支持)
+    class FdSink : public StreamSinkBuffer
+    {
+    public:
+        explicit FdSink(int fd, size_t chunk_size = DefaultChunkSize)
+            : StreamSinkBuffer(chunk_size)
+            , m_fd(fd)
+        {
+        #if INFRA_OS_WINDOWS
+            m_origin = _lseeki64(fd, 0, SEEK_CUR);
+        #else
+            m_origin = static_cast<int64_t>(::lseek(fd, 0, SEEK_CUR));
+        #endif
+        }
+
+        bool write(const uint8_t* data, size_t size) noexcept
+        {
+            size_t done = 0;
+            while (done < size)
+            {
+            #if INFRA_OS_WINDOWS
+                const size_t remain = size - done;
+                const int n = ::_write(m_fd, data + done, static_cast<unsigned>(remain < 0x40000000 ? remain : 0x40000000));
+            #else
+                const ssize_t n = ::write(m_fd, data + done, size - done);
+                if (n < 0 && errno == EINTR)
+                    continue;
+            #endif
+                if (n <= 0)
+                    return false;
+
+                done += static_cast<size_t>(n);
+            }
+
+            m_written += size;
+            return true;
+        }
+
+        // offset: 相对于sink创建时文件位置的偏移
+        bool patch(size_t offset, const uint8_t* data, size_t size) noexcept
+        {
+            if (m_origin < 0)
+                return false;
+
+            const int64_t pos = m_origin + static_cast<int64_t>(offset);
+
+        #if INFRA_OS_WINDOWS
+            // 没有pwrite，写完后回到文件末尾
+            const int64_t end = _lseeki64(m_fd, 0, SEEK_CUR);
+            if (end < 0 || _lseeki64(m_fd, pos, SEEK_SET) < 0)
+                return false;
+
+            const bool ok = ::_write(m_fd, data, static_cast<unsigned>(size)) == static_cast<int>(size);
+            return _lseeki64(m_fd, end, SEEK_SET) >= 0 && ok;
+        #else
+            size_t done = 0;
+            while (done < size)
+            {
+                const ssize_t n = ::pwrite(m_fd, data + done, size - done, static_cast<off_t>(pos + static_cast<int64_t>(done)));
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                    return false;
+
+                done += static_cast<size_t>(n);
+            }
+            return true;
+        #endif
+        }
+
+    private:
+        int m_fd;
+        int64_t m_origin = -1;
+    };
+
+    // 输出到FILE*，回填header时临时fseek回去，完成后回到原来的位置
+    class FileSink : public StreamSinkBuffer
+    {
+    public:
+        explicit FileSink(FILE* file, size_t chunk_size = DefaultChunkSize)
+            : StreamSinkBuffer(chunk_size)
+            , m_file(file)
+        {
+            m_origin = tell(file);
+        }
+
+        bool write(const uint8_t* data, size_t size) noexcept
+        {
+            if (std::fwrite(data, 1, size, m_file) != size)
+                return false;
+
+            m_written += size;
+            return true;
+        }
+
+        // offset: 相对于sink创建时文件位置的偏移
+        bool patch(size_t offset, const uint8_t* data, size_t size) noexcept
+        {
+            if (m_origin < 0)
+                return false;
+
+            const int64_t end = tell(m_file);
+            if (end < 0 || !seek(m_file, m_origin + static_cast<int64_t>(offset)))
+                return false;
+
+            const bool ok = std::fwrite(data, 1, size, m_file) == size;
+            return seek(m_file, end) && ok;
+        }
+
+    private:
+        static int64_t tell(FILE* file) noexcept
+        {
+        #if INFRA_OS_WINDOWS
+            return _ftelli64(file);
+        #else
+            return static_cast<int64_t>(::ftello(file));
+        #endif
+        }
+
+        static bool seek(FILE* file, int64_t pos) noexcept
+        {
+        #if INFRA_OS_WINDOWS
+            return _fseeki64(file, pos, SEEK_SET) == 0;
+        #else
+            return ::fseeko(file, static_cast<off_t>(pos), SEEK_SET) == 0;
+        #endif
+        }
+
+        FILE* m_file;
+        int64_t m_origin = -1;
+    };
+
+    template<typename Sink>
+        requires std::is_base_of_v<StreamSinkBuffer, Sink>
+    struct Adaptor<Sink>
+    {
+        using byte_type = uint8_t;
+
+        static constexpr bool resizeable() noexcept
+        {
+            return true;
+        }
+
+        static constexpr bool streaming() noexcept
+        {
+            return true;
+        }
+
+        static size_t size(const Sink& sink) noexcept
+        {
+            return sink.buffer().size();
+        }
+
+        static uint8_t* data(Sink& sink) noexcept
+        {
+            return sink.buffer().data();
+        }
+
+        static const uint8_t* data(const Sink& sink) noexcept
+        {
+            return sink.buffer().data();
+        }
+
+        static void resize(Sink& sink, size_t new_size) noexcept
+        {
+            sink.buffer().resize(new_size, 0);
+        }
+
+        static void push_back(Sink& sink, const uint8_t& val) noexcept
+        {
+            sink.buffer().push_back(val);
+        }
+
+        static size_t capacity(const Sink& sink) noexcept
+        {
+            return sink.chunk_size();
+        }
+
+        static void reserve(Sink&, size_t) noexcept
+        {
+        }
+
+        static bool write(Sink& sink, const uint8_t* data, size_t size) noexcept
+        {
+            return sink.write(data, size);
+        }
+
+        static bool patch(Sink& sink, size_t offset, const uint8_t* data, size_t size) noexcept
+        {
+            return sink.patch(offset, data, size);
+        }
+
+        static size_t written(const Sink& sink) noexcept
+        {
+            return sink.written();
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "infra/binary_serialization.cpp.hpp"
+
+namespace infra::binary_serialization
+{
+    // 可以随机访问的记录表，编码为:
+    // | length | (length + 1)个uint64_t的偏移 | 元素数据 |
+    // 偏移相对于元素数据的起点，第i个元素占用 [offset[i], offset[i + 1])，最后一个偏移为元素数据的总字节数
+    //
+    // 序列化: 用IndexedVector包装要写入的元素，变长元素会额外执行一遍to_bytes来统计每个元素的字节数
+    // 反序列化: 读取为IndexedTable<T>，只记录索引和元素数据的位置，不解码任何元素，之后按下标解码需要的元素
+    template<typename T>
+    struct IndexedVector
+    {
+        std::span<const T> elements;
+    };
+
+    template<typename T, typename Allocator>
+    IndexedVector(const std::vector<T, Allocator>&) -> IndexedVector<T>;
+
+    template<typename ByteContainer, typename T>
+    void to_bytes(
+        Writer<ByteContainer>& writer,
+        const IndexedVector<T>& table
+    ) noexcept
+    {
+        const auto& elements = table.elements;
+
+        const auto size = static_cast<uint64_t>(elements.size());
+        writer.length(size);
+
+        // index
+        uint64_t offset = 0;
+        if constexpr (Writer<ByteContainer>::counting())
+        {
+            // 偏移的值不会被使用，不需要统计每个元素的字节数; 计数模式不会读取传入的数据
+            writer.values(static_cast<const uint64_t*>(nullptr), elements.size() + 1);
+        }
+        else
+        {
+            writer.ensure_bytes((elements.size() + 1) * sizeof(uint64_t));
+            writer << offset;
+            for (const auto& elem : elements)
+            {
+                if constexpr (fixed_serialized_size_v<T> != 0)
+                {
+                    offset += fixed_serialized_size_v<T>;
+                }
+                else
+                {
+                    offset += writer.measure(elem);
+                }
+                writer << offset;
+            }
+        }
+
+        // elements
+        [[maybe_unused]] const size_t elements_begin = writer.current_offset();
+        if constexpr (is_bulk_serializable<T>)
+        {
+            writer.values(elements.data(), elements.size());
+        }
+        else
+        {
+            if constexpr (fixed_serialized_size_v<T> != 0)
+            {
+                writer.ensure_bytes(elements.size() * fixed_serialized_size_v<T>);
+            }
+
+            for (const auto& elem : elements)
+            {
+                writer << elem;
+            }
+        }
+
+        // 索引是按fixed_serialized_size或者measure的结果生成的，必须与实际写入的字节数一致
+        if constexpr (!Writer<ByteContainer>::counting())
+        {
+            INFRA_DEBUG_ASSERT_WITH_MSG(writer.result() != ResultCode::OK || writer.current_offset() - elements_begin == offset,
+                "IndexedVector offsets do not match the bytes written by to_bytes.");
+        }
+    }
+
+    // 源缓冲区销毁后失效; 源缓冲区是deserialize内部的临时缓冲区时(压缩的数据)，索引和元素数据会复制到表自己的存储中
+    template<typename T>
+    class IndexedTable
+    {
+        template<typename ByteContainer, typename U>
+        friend void from_bytes(Reader<ByteContainer>& reader, IndexedTable<U>& table) noexcept;
+
+    private:
+        const uint8_t* m_offsets = nullptr;     // m_count + 1个小端序的uint64_t，不要求对齐
+        const uint8_t* m_data = nullptr;
+        size_t m_count = 0;
+        size_t m_data_size = 0;
+        bool m_compact_length = false;
+
+        // 复制出来的索引 + 元素数据，不为空时m_offsets和m_data不使用
+        std::vector<uint8_t> m_storage{};
+
+        [[nodiscard]] const uint8_t* offsets() const noexcept
+        {
+            return m_storage.empty() ? m_offsets : m_storage.data();
+        }
+
+        [[nodiscard]] const uint8_t* data() const noexcept
+        {
+            return m_storage.empty() ? m_data : m_storage.data() + (m_count + 1) * sizeof(uint64_t);
+        }
+
+        [[nodiscard]] uint64_t offset(size_t index) const noexcept
+        {
+            uint64_t v = 0;
+            memcpy(&v, offsets() + index * sizeof(uint64_t), sizeof(v));
+            endian::to_little(&v, sizeof(v));
+            return v;
+        }
+
+    public:
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return m_count;
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return m_count == 0;
+        }
+
+        // 第index个元素编码后的字节，下标越界或者索引损坏时为空
+        [[nodiscard]] std::span<const uint8_t> bytes(size_t index) const noexcept
+        {
+            if (index >= m_count)
+                return {};
+
+            const uint64_t begin = offset(index);
+            const uint64_t end = offset(index + 1);
+            if (begin > end || end > m_data_size)
+                return {};
+
+            return std::span<const uint8_t>(data() + begin, static_cast<size_t>(end - begin));
+        }
+
+        // 只解码第index个元素，不经过它之前的任何元素
+        ResultCode get(size_t index, T& elem) const noexcept
+        {
+            if (index >= m_count)
+                return ResultCode::InvalidIndex;
+
+            const uint64_t begin = offset(index);
+            const uint64_t end = offset(index + 1);
+            if (begin > end || end > m_data_size)
+                return ResultCode::InvalidIndex;
+
+            return deserialize_range(data() + begin, static_cast<size_t>(end - begin), elem, m_compact_length);
+        }
+
+        // 解码 [first, first + count) 范围内的元素，追加到out的末尾
+        template<typename Allocator>
+        ResultCode get_range(size_t first, size_t count, std::vector<T, Allocator>& out) const noexcept
+        {
+            if (first > m_count || count > m_count - first)
+                return ResultCode::InvalidIndex;
+
+            out.reserve(out.size() + count);
+            for (size_t i = first; i < first + count; ++i)
+            {
+                const ResultCode code = get(i, out.emplace_back());
+                if (code != ResultCode::OK)
+                {
+                    out.pop_back();
+                    return code;
+                }
+            }
+            return ResultCode::OK;
+        }
+    };
+
+    template<typename T>
+    struct holds_buffer_view<IndexedTable<T>> : std::true_type {};
+
+    // 长度前缀 + 至少一个偏移
+    template<typename T>
+    struct length_prefix_count<IndexedTable<T>> : std::integral_constant<size_t, 1> {};
+
+    template<typename T>
+    struct min_serialized_size<IndexedTable<T>> : std::integral_constant<size_t, sizeof(uint64_t)> {};
+
+    template<typename ByteContainer, typename T>
+    void from_bytes(
+        Reader<ByteContainer>& reader,
+        IndexedTable<T>& table
+    ) noexcept
+    {
+        uint64_t size = 0;
+        reader.length(size);
+        if (!reader.check_length(size, sizeof(uint64_t)))
+            return;
+
+        const size_t count = static_cast<size_t>(size);
+        const uint8_t* offsets = reader.template borrow<uint8_t>((count + 1) * sizeof(uint64_t));
+        if (offsets == nullptr)
+            return;
+
+        uint64_t data_size = 0;
+        memcpy(&data_size, offsets + count * sizeof(uint64_t), sizeof(data_size));
+        endian::to_little(&data_size, sizeof(data_size));
+        if (!reader.check_length(data_size, 1))
+            return;
+
+        const uint8_t* data = reader.template borrow<uint8_t>(static_cast<size_t>(data_size));
+        if (data == nullptr)
+            return;
+
+        table.m_count = count;
+        table.m_data_size = static_cast<size_t>(data_size);
+        table.m_compact_length = reader.compact_length();
+        if (reader.transient_buffer())
+        {
+            // 索引和元素数据在源缓冲区中是连续的
+            table.m_offsets = nullptr;
+            table.m_data = nullptr;
+            table.m_storage.assign(offsets, data + table.m_data_size);
+        }
+        else
+        {
+            table.m_offsets = offsets;
+            table.m_data = data;
+            table.m_storage.clear();
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "infra/binary_serialization.cpp.hpp"
+
+namespace infra::binary_serialization
+{
+    // 延迟解码的字段，编码为 | 字节数(长度前缀) | T的编码 |
+    // 反序列化时只记录T的字节范围(O(1)跳过)，第一次get时才执行T的from_bytes
+    // 没有访问过的字段再次序列化时直接原样写回记录的字节，不需要解码
+    // 序列化时会额外执行一遍T的to_bytes来统计字节数(定长的T、长度前缀为uint64_t时的serialized_size除外)
+    // 解码前引用源缓冲区，源缓冲区销毁后不能再get; 延迟解码会修改内部状态，多个线程同时get需要外部同步
+    // 源缓冲区是deserialize内部的临时缓冲区时(压缩的数据)，T的编码会复制到Lazy自己的存储中
+    template<typename T>
+    class Lazy
+    {
+        template<typename ByteContainer, typename U>
+        friend void to_bytes(Writer<ByteContainer>& writer, const Lazy<U>& lazy) noexcept;
+
+        template<typename ByteContainer, typename U>
+        friend void from_bytes(Reader<ByteContainer>& reader, Lazy<U>& lazy) noexcept;
+
+    private:
+        mutable std::optional<T> m_value;
+        mutable ResultCode m_result = ResultCode::OK;
+
+        // 还没有解码时T的编码，m_storage不为空时使用复制出来的编码
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+        bool m_compact_length = false;
+        std::vector<uint8_t> m_storage{};
+
+        [[nodiscard]] const uint8_t* data() const noexcept
+        {
+            return m_storage.empty() ? m_data : m_storage.data();
+        }
+
+    public:
+        Lazy()
+            : m_value(std::in_place)
+        {
+        }
+
+        Lazy(T value)
+            : m_value(std::move(value))
+        {
+        }
+
+        // 是否已经解码(或者是直接赋值的)
+        [[nodiscard]] bool decoded() const noexcept
+        {
+            return m_value.has_value();
+        }
+
+        // 第一次调用时解码，失败时返回nullptr，错误码由result()返回
+        const T* get() const noexcept
+        {
+            if (!m_value.has_value())
+            {
+                if (m_result != ResultCode::OK)
+                    return nullptr;
+
+                m_result = deserialize_range(data(), m_size, m_value.emplace(), m_compact_length);
+                if (m_result != ResultCode::OK)
+                {
+                    m_value.reset();
+                    return nullptr;
+                }
+            }
+            return &*m_value;
+        }
+
+        // 修改之后，序列化时写入修改后的值
+        T* get() noexcept
+        {
+            return const_cast<T*>(std::as_const(*this).get());
+        }
+
+        void set(T value)
+        {
+            m_value = std::move(value);
+            m_result = ResultCode::OK;
+        }
+
+        // 最近一次解码的结果
+        [[nodiscard]] ResultCode result() const noexcept
+        {
+            return m_result;
+        }
+    };
+
+    template<typename T>
+    struct holds_buffer_view<Lazy<T>> : std::true_type {};
+
+    template<typename T>
+    struct length_prefix_count<Lazy<T>> : std::integral_constant<size_t, 1> {};
+
+    template<typename ByteContainer, typename T>
+    void to_bytes(
+        Writer<ByteContainer>& writer,
+        const Lazy<T>& lazy
+    ) noexcept
+    {
+        // 记录的字节与当前的编码方式相同时原样写回
+        if (!lazy.decoded() && lazy.m_result == ResultCode::OK && lazy.m_compact_length == writer.compact_length())
+        {
+            writer.length(static_cast<uint64_t>(lazy.m_size));
+            writer.values(lazy.data(), lazy.m_size);
+            return;
+        }
+
+        const T* value = lazy.get();
+        if (value == nullptr)
+        {
+            writer.abort();
+            return;
+        }
+
+        uint64_t size = 0;
+        [[maybe_unused]] bool measured = true;
+        if constexpr (fixed_serialized_size_v<T> != 0)
+        {
+            size = fixed_serialized_size_v<T>;
+        }
+        else if constexpr (Writer<ByteContainer>::counting())
+        {
+            // 定长的长度前缀不需要知道实际的字节数，避免嵌套时每一层都多执行一遍to_bytes
+            if (writer.compact_length())
+            {
+                size = static_cast<uint64_t>(writer.measure(*value));
+            }
+            else
+            {
+                measured = false;
+            }
+        }
+        else
+        {
+            size = static_cast<uint64_t>(writer.measure(*value));
+        }
+        writer.length(size);
+
+        // 长度前缀必须与实际写入的字节数一致，否则读取时会错位
+        [[maybe_unused]] const size_t begin = writer.current_offset();
+        writer << *value;
+        INFRA_DEBUG_ASSERT_WITH_MSG(!measured || writer.result() != ResultCode::OK || writer.current_offset() - begin == size,
+            "Lazy length prefix does not match the bytes written by to_bytes.");
+    }
+
+    template<typename ByteContainer, typename T>
+    void from_bytes(
+        Reader<ByteContainer>& reader,
+        Lazy<T>& lazy
+    ) noexcept
+    {
+        uint64_t size = 0;
+        reader.length(size);
+        if (!reader.check_length(size, 1))
+            return;
+
+        const uint8_t* data = reader.template borrow<uint8_t>(static_cast<size_t>(size));
+        if (data == nullptr)
+            return;
+
+        lazy.m_value.reset();
+        lazy.m_result = ResultCode::OK;
+        lazy.m_size = static_cast<size_t>(size);
+        lazy.m_compact_length = reader.compact_length();
+        if (reader.transient_buffer())
+        {
+            lazy.m_data = nullptr;
+            lazy.m_storage.assign(data, data + lazy.m_size);
+        }
+        else
+        {
+            lazy.m_data = data;
+            lazy.m_storage.clear();
+        }
+    }
+}
\ No newline at end of file
@@ -7,6 +7,9 @@
 
 namespace infra::binary_serialization
 {
+    template<typename Char, typename CharTraits, typename Allocator>
+    struct length_prefix_count<std::basic_string<Char, CharTraits, Allocator>> : std::integral_constant<size_t, 1> {};
+
     template<typename ByteContainer, is_serializable_char Char, typename CharTraits, typename Allocator>
     void to_bytes(
         Writer<ByteContainer>& writer,
@@ -14,12 +17,10 @@ namespace infra::binary_serialization
     ) noexcept
     {
         const auto size = static_cast<uint64_t>(str.size());
-        writer << size;
+        writer.length(size);
 
-        for (uint64_t i = 0; i < size; ++i)
-        {
-            writer << str[static_cast<std::basic_string<Char, CharTraits, Allocator>::size_type>(i)];
-        }
+        // 字符连续存储，整体拷贝(多字节字符在大端序主机上逐个转换字节序)
+        writer.values(str.data(), str.size());
     }
 
     template<typename ByteContainer, is_serializable_char Char, typename CharTraits, typename Allocator>
@@ -29,16 +30,33 @@ namespace infra::binary_serialization
     ) noexcept
     {
         uint64_t size = 0;
-        reader >> size;
+        reader.length(size);
+        if (!reader.check_length(size, sizeof(Char)))
+            return;
 
         using str_size_t = std::basic_string<Char, CharTraits, Allocator>::size_type;
 
-        str.clear();
-        str.resize(static_cast<str_size_t>(size));
+        const auto count = static_cast<str_size_t>(size);
 
-        for (uint64_t i = 0; i < size; ++i)
+        // 直接从源缓冲区拷贝构造，不需要先用resize清零
+        if (reader.template can_borrow<Char>(count))
         {
-            reader >> str[static_cast<str_size_t>(i)];
+            const Char* src = reader.template borrow<Char>(count);
+            str.assign(src, count);
+            return;
         }
+
+    #if defined(__cpp_lib_string_resize_and_overwrite)
+        str.resize_and_overwrite(count, [&reader](Char* dst, str_size_t n) noexcept
+        {
+            reader.values(dst, n);
+            return reader.result() == ResultCode::OK ? n : 0;
+        });
+    #else
+        str.clear();
+        str.resize(count);
+
+        reader.values(str.data(), str.size());
+    #endif
     }
 }
\ No newline at end of file
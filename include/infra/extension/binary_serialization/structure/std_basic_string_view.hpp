@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "infra/binary_serialization.cpp.hpp"
+
+namespace infra::binary_serialization
+{
+    // 编码与std::basic_string相同，两者可以互相读写
+    // 反序列化不分配内存，视图直接指向源缓冲区，源缓冲区销毁后失效
+    template<typename Char, typename CharTraits>
+    struct holds_buffer_view<std::basic_string_view<Char, CharTraits>> : std::true_type {};
+
+    template<typename Char, typename CharTraits>
+    struct length_prefix_count<std::basic_string_view<Char, CharTraits>> : std::integral_constant<size_t, 1> {};
+
+    template<typename ByteContainer, is_serializable_char Char, typename CharTraits>
+    void to_bytes(
+        Writer<ByteContainer>& writer,
+        const std::basic_string_view<Char, CharTraits>& str
+    ) noexcept
+    {
+        const auto size = static_cast<uint64_t>(str.size());
+        writer.length(size);
+
+        writer.values(str.data(), str.size());
+    }
+
+    template<typename ByteContainer, is_serializable_char Char, typename CharTraits>
+    void from_bytes(
+        Reader<ByteContainer>& reader,
+        std::basic_string_view<Char, CharTraits>& str
+    ) noexcept
+    {
+        uint64_t size = 0;
+        reader.length(size);
+        if (!reader.check_length(size, sizeof(Char)))
+            return;
+
+        const Char* data = reader.template borrow<Char>(static_cast<size_t>(size));
+        if (data == nullptr)
+            return;
+
+        str = std::basic_string_view<Char, CharTraits>(data, static_cast<size_t>(size));
+    }
+}
\ No newline at end of file
@@ -6,6 +6,12 @@
 
 namespace infra::binary_serialization
 {
+    template<typename Key, typename Value, typename Compare, typename Allocator>
+    struct holds_buffer_view<std::map<Key, Value, Compare, Allocator>> : std::bool_constant<holds_buffer_view_v<Key> || holds_buffer_view_v<Value>> {};
+
+    template<typename Key, typename Value, typename Compare, typename Allocator>
+    struct length_prefix_count<std::map<Key, Value, Compare, Allocator>> : std::integral_constant<size_t, 1> {};
+
     template<typename ByteContainer, typename Key, typename Value, typename Compare, typename Allocator>
     void to_bytes(
         Writer<ByteContainer>& writer,
@@ -13,7 +19,7 @@ namespace infra::binary_serialization
     ) noexcept
     {
         const uint64_t size = static_cast<uint64_t>(m.size());
-        writer << size;
+        writer.length(size);
 
         for (const auto& [k, v] : m)
         {
@@ -29,7 +35,9 @@ namespace infra::binary_serialization
     ) noexcept
     {
         uint64_t size = 0;
-        reader >> size;
+        reader.length(size);
+        if (!reader.template check_length<Key, Value>(size))
+            return;
 
         m.clear();
         for (uint64_t i = 0; i < size; ++i)
@@ -6,6 +6,18 @@
 
 namespace infra::binary_serialization
 {
+    template<typename T1, typename T2>
+    struct fixed_serialized_size<std::pair<T1, T2>> : fixed_serialized_size_sum<T1, T2> {};
+
+    template<typename T1, typename T2>
+    struct holds_buffer_view<std::pair<T1, T2>> : std::bool_constant<holds_buffer_view_v<T1> || holds_buffer_view_v<T2>> {};
+
+    template<typename T1, typename T2>
+    struct min_serialized_size<std::pair<T1, T2>> : std::integral_constant<size_t, min_serialized_size_v<T1> + min_serialized_size_v<T2>> {};
+
+    template<typename T1, typename T2>
+    struct length_prefix_count<std::pair<T1, T2>> : std::integral_constant<size_t, length_prefix_count_v<T1> + length_prefix_count_v<T2>> {};
+
     template<typename ByteContainer, typename T1, typename T2>
     void to_bytes(
         Writer<ByteContainer>& writer,
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "infra/binary_serialization.cpp.hpp"
+
+namespace infra::binary_serialization
+{
+    // 编码与std::vector相同，两者可以互相读写
+    // 反序列化只支持std::span<const T>(T为数值或memcpy结构体)，不拷贝，直接指向源缓冲区，源缓冲区销毁后失效
+    // 元素必须按alignof(T)对齐: 默认的V1 header之后，顶层span的元素位于偏移20，8字节元素(double、uint64_t)总是UnalignedView，
+    // 需要使用HeaderVersion::V2(元素位于偏移32)，并且源缓冲区本身按8字节对齐
+    template<typename T, size_t Extent>
+    struct holds_buffer_view<std::span<const T, Extent>> : std::true_type {};
+
+    template<typename T, size_t Extent>
+    struct length_prefix_count<std::span<T, Extent>> : std::integral_constant<size_t, 1> {};
+
+    template<typename ByteContainer, typename T, size_t Extent>
+    void to_bytes(
+        Writer<ByteContainer>& writer,
+        const std::span<T, Extent>& span
+    ) noexcept
+    {
+        const auto size = static_cast<uint64_t>(span.size());
+        writer.length(size);
+
+        using elem_t = std::remove_cv_t<T>;
+        if constexpr (is_bulk_serializable<elem_t>)
+        {
+            writer.values(static_cast<const elem_t*>(span.data()), span.size());
+        }
+        else
+        {
+            if constexpr (fixed_serialized_size_v<elem_t> != 0)
+            {
+                writer.ensure_bytes(span.size() * fixed_serialized_size_v<elem_t>);
+            }
+
+            for (const auto& elem : span)
+            {
+                writer << elem;
+            }
+        }
+    }
+
+    template<typename ByteContainer, is_bulk_serializable T>
+    void from_bytes(
+        Reader<ByteContainer>& reader,
+        std::span<const T>& span
+    ) noexcept
+    {
+        uint64_t size = 0;
+        reader.length(size);
+        if (!reader.check_length(size, sizeof(T)))
+            return;
+
+        const T* data = reader.template borrow<T>(static_cast<size_t>(size));
+        if (data == nullptr)
+            return;
+
+        span = std::span<const T>(data, static_cast<size_t>(size));
+    }
+}
\ No newline at end of file
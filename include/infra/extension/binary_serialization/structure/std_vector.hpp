@@ -1,11 +1,120 @@
 #pragma once
 
+#include <cstdint>
+#include <cstring>
+#include <iterator>
 #include <vector>
 
 #include "infra/binary_serialization.cpp.hpp"
 
 namespace infra::binary_serialization
 {
+    namespace detail
+    {
+        // 按sizeof(T)步进，每次用memcpy从未对齐的字节中读出一个T，vector::assign可以用它直接拷贝构造，不要求对齐
+        // 解引用返回值而不是引用，不满足旧式forward iterator的要求，所以iterator_category只能是input iterator
+        template<typename T>
+        class UnalignedIterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using iterator_concept = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = T;
+
+            UnalignedIterator() noexcept = default;
+
+            explicit UnalignedIterator(const uint8_t* ptr) noexcept
+                : m_ptr(ptr)
+            {
+            }
+
+            T operator*() const noexcept
+            {
+                T v;
+                memcpy(&v, m_ptr, sizeof(T));
+                return v;
+            }
+
+            T operator[](difference_type n) const noexcept
+            {
+                return *(*this + n);
+            }
+
+            UnalignedIterator& operator++() noexcept
+            {
+                m_ptr += sizeof(T);
+                return *this;
+            }
+
+            UnalignedIterator operator++(int) noexcept
+            {
+                UnalignedIterator old = *this;
+                m_ptr += sizeof(T);
+                return old;
+            }
+
+            UnalignedIterator& operator--() noexcept
+            {
+                m_ptr -= sizeof(T);
+                return *this;
+            }
+
+            UnalignedIterator operator--(int) noexcept
+            {
+                UnalignedIterator old = *this;
+                m_ptr -= sizeof(T);
+                return old;
+            }
+
+            UnalignedIterator& operator+=(difference_type n) noexcept
+            {
+                m_ptr += n * static_cast<difference_type>(sizeof(T));
+                return *this;
+            }
+
+            UnalignedIterator& operator-=(difference_type n) noexcept
+            {
+                m_ptr -= n * static_cast<difference_type>(sizeof(T));
+                return *this;
+            }
+
+            friend UnalignedIterator operator+(UnalignedIterator it, difference_type n) noexcept
+            {
+                return it += n;
+            }
+
+            friend UnalignedIterator operator+(difference_type n, UnalignedIterator it) noexcept
+            {
+                return it += n;
+            }
+
+            friend UnalignedIterator operator-(UnalignedIterator it, difference_type n) noexcept
+            {
+                return it -= n;
+            }
+
+            friend difference_type operator-(const UnalignedIterator& lhs, const UnalignedIterator& rhs) noexcept
+            {
+                return (lhs.m_ptr - rhs.m_ptr) / static_cast<difference_type>(sizeof(T));
+            }
+
+            friend bool operator==(const UnalignedIterator&, const UnalignedIterator&) noexcept = default;
+            friend auto operator<=>(const UnalignedIterator&, const UnalignedIterator&) noexcept = default;
+
+        private:
+            const uint8_t* m_ptr = nullptr;
+        };
+    }
+
+    template<typename T, typename Allocator>
+    struct holds_buffer_view<std::vector<T, Allocator>> : holds_buffer_view<T> {};
+
+    template<typename T, typename Allocator>
+    struct length_prefix_count<std::vector<T, Allocator>> : std::integral_constant<size_t, 1> {};
+
     template<typename ByteContainer, typename T, typename Allocator>
     void to_bytes(
         Writer<ByteContainer>& writer,
@@ -13,13 +122,26 @@ namespace infra::binary_serialization
     ) noexcept
     {
         const auto size = static_cast<uint64_t>(vec.size());
-        writer << size;
+        writer.length(size);
 
-        using vec_size_t = std::vector<T, Allocator>::size_type;
-
-        for (uint64_t i = 0; i < size; ++i)
+        // 定长数值和memcpy结构体直接整体拷贝
+        if constexpr (is_bulk_serializable<T>)
         {
-            writer << vec[static_cast<vec_size_t>(i)];
+            writer.values(vec.data(), vec.size());
+        }
+        else
+        {
+            if constexpr (fixed_serialized_size_v<T> != 0)
+            {
+                writer.ensure_bytes(vec.size() * fixed_serialized_size_v<T>);
+            }
+
+            using vec_size_t = std::vector<T, Allocator>::size_type;
+
+            for (uint64_t i = 0; i < size; ++i)
+            {
+                writer << vec[static_cast<vec_size_t>(i)];
+            }
         }
     }
 
@@ -30,16 +152,58 @@ namespace infra::binary_serialization
     ) noexcept
     {
         uint64_t size = 0;
-        reader >> size;
+        reader.length(size);
+        if (!reader.template check_length<T>(size))
+            return;
 
         using vec_size_t = std::vector<T, Allocator>::size_type;
 
-        vec.clear();
-        vec.resize(static_cast<vec_size_t>(size));
+        // 定长数值和memcpy结构体直接整体拷贝
+        if constexpr (is_bulk_serializable<T>)
+        {
+            const auto count = static_cast<vec_size_t>(size);
+
+            // 直接从源缓冲区拷贝构造，不需要先用resize清零
+            if (reader.template can_borrow<T>(count))
+            {
+                const T* src = reader.template borrow<T>(count);
+                vec.assign(src, src + count);
+                return;
+            }
+
+            // 没有对齐时逐个memcpy构造，同样不需要清零(只有大端序主机需要先拷贝再转换字节序)
+            if constexpr (endian::Current == endian::Endian::Little)
+            {
+                if (reader.template can_borrow<uint8_t>(count * sizeof(T)))
+                {
+                    const uint8_t* src = reader.template borrow<uint8_t>(count * sizeof(T));
 
-        for (uint64_t i = 0; i < size; ++i)
+                    // 按input iterator处理时assign不会预先计算元素个数，先一次性分配好
+                    vec.clear();
+                    vec.reserve(count);
+                    vec.assign(detail::UnalignedIterator<T>(src), detail::UnalignedIterator<T>(src + count * sizeof(T)));
+                    return;
+                }
+            }
+
+            vec.clear();
+            vec.resize(count);
+            reader.values(vec.data(), vec.size());
+        }
+        else
         {
-            reader >> vec[static_cast<vec_size_t>(i)];
+            vec.clear();
+            vec.resize(static_cast<vec_size_t>(size));
+
+            if constexpr (fixed_serialized_size_v<T> != 0)
+            {
+                reader.ensure_bytes(vec.size() * fixed_serialized_size_v<T>);
+            }
+
+            for (uint64_t i = 0; i < size; ++i)
+            {
+                reader >> vec[static_cast<vec_size_t>(i)];
+            }
         }
     }
 }
\ No newline at end of file
@@ -19,10 +19,17 @@
 #define INFRA_BINARY_SERIALIZATION_IMPL
 #include <infra/binary_serialization.cpp.hpp>
 #include <infra/extension/binary_serialization/adaptors/std_array.hpp>
+#include <infra/extension/binary_serialization/adaptors/std_span.hpp>
 #include <infra/extension/binary_serialization/adaptors/std_vector.hpp>
+#include <infra/extension/binary_serialization/adaptors/mapped_file.hpp>
+#include <infra/extension/binary_serialization/adaptors/stream_sink.hpp>
 #include <infra/extension/binary_serialization/structure/std_basic_string.hpp>
+#include <infra/extension/binary_serialization/structure/std_basic_string_view.hpp>
+#include <infra/extension/binary_serialization/structure/indexed_table.hpp>
+#include <infra/extension/binary_serialization/structure/lazy.hpp>
 #include <infra/extension/binary_serialization/structure/std_map.hpp>
 #include <infra/extension/binary_serialization/structure/std_pair.hpp>
+#include <infra/extension/binary_serialization/structure/std_span.hpp>
 #include <infra/extension/binary_serialization/structure/std_vector.hpp>
 
 #if INFRA_ARCH_X86
@@ -152,6 +159,41 @@ void x86_crc32c_speed()
         std::cout << "Result: " << crc << "\n";
     }
 
+    {
+        ScopeTimer timer("CRC32C sse4.2 3-way");
+        crc = infra::binary_serialization::detail::update_crc32c_checksum_x86_3way(0, buffer.data(), buffer.size());
+        std::cout << "Result: " << crc << "\n";
+    }
+
+    using infra::binary_serialization::detail::Crc32cKernel;
+    const auto kernel = infra::binary_serialization::detail::crc32c_kernel();
+
+    if (kernel == Crc32cKernel::Pclmul || kernel == Crc32cKernel::Vpclmul)
+    {
+        ScopeTimer timer("CRC32C pclmul");
+        crc = infra::binary_serialization::detail::update_crc32c_checksum_x86_pclmul(0, buffer.data(), buffer.size());
+        std::cout << "Result: " << crc << "\n";
+    }
+
+    if (kernel == Crc32cKernel::Vpclmul)
+    {
+        ScopeTimer timer("CRC32C vpclmul");
+        crc = infra::binary_serialization::detail::update_crc32c_checksum_x86_vpclmul(0, buffer.data(), buffer.size());
+        std::cout << "Result: " << crc << "\n";
+    }
+
+    {
+        ScopeTimer timer("CRC32C slice-by-16");
+        crc = infra::binary_serialization::detail::update_crc32c_checksum_slice16(0, buffer.data(), buffer.size());
+        std::cout << "Result: " << crc << "\n";
+    }
+
+    {
+        ScopeTimer timer("CRC32C slice-by-8");
+        crc = infra::binary_serialization::detail::update_crc32c_checksum_slice8(0, buffer.data(), buffer.size());
+        std::cout << "Result: " << crc << "\n";
+    }
+
     {
         ScopeTimer timer("CRC32C scalar 8");
         crc = infra::binary_serialization::detail::update_crc32c_checksum_scalar(0, buffer.data(), buffer.size());
@@ -404,6 +446,112 @@ void checksum_test_large_1024()
 #endif
 }
 
+void checksum_test_interleaved()
+{
+#if INFRA_ARCH_X86_64
+    std::vector<uint8_t> data(8192 * 3 * 2 + 256 * 3 * 2 + 123);
+    std::mt19937 rng(42);
+    for (auto& b : data) b = static_cast<uint8_t>(rng());
+
+    // 覆盖长块、短块、单路尾部的各种组合，起始地址故意不对齐
+    for (size_t size : { size_t{ 0 }, size_t{ 767 }, size_t{ 768 }, size_t{ 769 }, size_t{ 8192 * 3 - 1 }, size_t{ 8192 * 3 },
+                         size_t{ 8192 * 3 + 256 * 3 + 7 }, data.size() - 1 })
+    {
+        for (uint32_t origin : { 0u, 0x12345678u })
+        {
+            auto scalar = infra::binary_serialization::detail::update_crc32c_checksum_scalar(origin, data.data() + 1, size);
+            auto x86 = infra::binary_serialization::detail::update_crc32c_checksum_x86_3way(origin, data.data() + 1, size);
+            ASSERT(scalar == x86);
+        }
+    }
+#endif
+}
+
+void checksum_test_folding()
+{
+#if INFRA_ARCH_X86_64
+    using infra::binary_serialization::detail::Crc32cKernel;
+    const auto kernel = infra::binary_serialization::detail::crc32c_kernel();
+
+    std::vector<uint8_t> data(4096 + 64);
+    std::mt19937 rng(7);
+    for (auto& b : data) b = static_cast<uint8_t>(rng());
+
+    // 覆盖最小长度边界、各级折叠后的尾部，起始地址故意不对齐
+    for (size_t size : { size_t{ 0 }, size_t{ 255 }, size_t{ 256 }, size_t{ 257 }, size_t{ 320 }, size_t{ 1023 }, size_t{ 1024 },
+                         size_t{ 1024 + 64 + 16 + 5 }, size_t{ 2048 + 255 }, size_t{ 4096 } })
+    {
+        for (uint32_t origin : { 0u, 0xDEADBEEFu })
+        {
+            const uint8_t* p = data.data() + 3;
+            auto scalar = infra::binary_serialization::detail::update_crc32c_checksum_scalar(origin, p, size);
+            ASSERT(scalar == infra::binary_serialization::update_crc32c_checksum(origin, p, size));
+
+            if (kernel == Crc32cKernel::Pclmul || kernel == Crc32cKernel::Vpclmul)
+            {
+                ASSERT(scalar == infra::binary_serialization::detail::update_crc32c_checksum_x86_pclmul(origin, p, size));
+            }
+
+            if (kernel == Crc32cKernel::Vpclmul)
+            {
+                ASSERT(scalar == infra::binary_serialization::detail::update_crc32c_checksum_x86_vpclmul(origin, p, size));
+            }
+        }
+    }
+#endif
+}
+
+void checksum_test_combine()
+{
+    using namespace infra::binary_serialization;
+
+    static_assert(crc32c_combine(0x12345678, 0, 0) == 0x12345678);
+
+    std::vector<uint8_t> data(10 * 1024 * 1024 + 13);
+    std::mt19937 rng(11);
+    for (auto& b : data) b = static_cast<uint8_t>(rng());
+
+    // crc(A|B) = combine(crc(A), crc(B), |B|)
+    for (size_t split : { size_t{ 0 }, size_t{ 1 }, size_t{ 1000 }, data.size() / 2, data.size() })
+    {
+        for (uint32_t origin : { 0u, 0xCAFEBABEu })
+        {
+            const auto crc_a = update_crc32c_checksum(origin, data.data(), split);
+            const auto crc_b = update_crc32c_checksum(0, data.data() + split, data.size() - split);
+            ASSERT(crc32c_combine(crc_a, crc_b, data.size() - split) == update_crc32c_checksum(origin, data.data(), data.size()));
+        }
+    }
+
+    // 多线程结果与单线程完全相同，包括块数不能整除、线程数超过可切分块数的情况
+    const auto expected = update_crc32c_checksum(0x1111, data.data(), data.size());
+    for (unsigned threads : { 0u, 1u, 2u, 3u, 64u })
+    {
+        ASSERT(update_crc32c_checksum_parallel(0x1111, data.data(), data.size(), threads) == expected);
+    }
+    ASSERT(update_crc32c_checksum_parallel(0x1111, data.data(), 100, 4) == update_crc32c_checksum(0x1111, data.data(), 100));
+}
+
+void checksum_test_slice()
+{
+    using namespace infra::binary_serialization::detail;
+
+    static_assert(crc32c_slice_table[0] == crc32c_table);
+
+    uint8_t data[300];
+    for (int i = 0; i < 300; ++i) data[i] = uint8_t(i * 31 + 5);
+
+    // 各种长度和不对齐的起始地址
+    for (size_t offset = 0; offset < 4; ++offset)
+    {
+        for (size_t size = 0; size + offset <= 300; size += 7)
+        {
+            const auto scalar = update_crc32c_checksum_scalar(0x5A5A5A5A, data + offset, size);
+            ASSERT(scalar == update_crc32c_checksum_slice8(0x5A5A5A5A, data + offset, size));
+            ASSERT(scalar == update_crc32c_checksum_slice16(0x5A5A5A5A, data + offset, size));
+        }
+    }
+}
+
 void checksum_test()
 {
     x86_crc32c_speed();
@@ -421,6 +569,10 @@ void checksum_test()
     checksum_test_chunk_equivalence();
     checksum_test_unaligned_pointer();
     checksum_test_large_1024();
+    checksum_test_interleaved();
+    checksum_test_folding();
+    checksum_test_combine();
+    checksum_test_slice();
 }
 
 #pragma endregion checksum_test
@@ -1706,14 +1858,11 @@ void custom_structure_test()
 }
 
 
-
-struct Storage_Bool
+struct Storage_BulkValues
 {
-    uint64_t a;
-    bool b1;
-    uint32_t c;
-    bool b2;
-    bool b3[3][2];
+    std::vector<float> floats;
+    std::vector<uint32_t> u32s;
+    int16_t grid[3][4];
 };
 
 namespace infra::binary_serialization
@@ -1721,162 +1870,2439 @@ namespace infra::binary_serialization
     template<typename ByteContainer>
     void from_bytes(
         Reader<ByteContainer>& reader,
-        Storage_Bool& storage
+        Storage_BulkValues& storage
     )
     {
-        reader >> storage.a;
-        reader >> storage.b1;
-        reader >> storage.c;
-        reader >> storage.b2;
-        reader >> storage.b3;
+        reader >> storage.floats;
+        reader >> storage.u32s;
+        reader >> storage.grid;
     }
 
     template<typename ByteContainer>
     void to_bytes(
         Writer<ByteContainer>& writer,
-        const Storage_Bool& storage
+        const Storage_BulkValues& storage
     )
     {
-        writer << storage.a;
-        writer << storage.b1;
-        writer << storage.c;
-        writer << storage.b2;
-        writer << storage.b3;
+        writer << storage.floats;
+        writer << storage.u32s;
+        writer << storage.grid;
     }
 }
 
-void bool_test()
+// 数值数组走整体拷贝路径，编码结果必须和逐元素写入完全一致
+void bulk_values_test()
 {
     using namespace infra::binary_serialization;
 
+    Storage_BulkValues storage{};
+    for (uint32_t i = 0; i < 1000; ++i)
     {
-        Storage_Bool storage{
-            0x0102030405060708ULL,
-            true,
-            0x11223344,
-            false,
-            { {true, false}, {false, true}, {true, true} } // b3
-        };
+        storage.floats.push_back(static_cast<float>(i) * 0.5f);
+        storage.u32s.push_back(0x01020304u + i);
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+        {
+            storage.grid[i][j] = static_cast<int16_t>(-(i * 4 + j));
+        }
+    }
 
-        std::vector<uint8_t> buffer{};
-        infra::binary_serialization::serialize(buffer, storage);
+    std::vector<uint8_t> buffer{};
+    auto result = serialize(buffer, storage);
+    ASSERT(result);
 
-        // magic
-        ASSERT(buffer[detail::MagicOffset + 0] == detail::MagicValue[0]);
-        ASSERT(buffer[detail::MagicOffset + 1] == detail::MagicValue[1]);
-        ASSERT(buffer[detail::MagicOffset + 2] == detail::MagicValue[2]);
-        ASSERT(buffer[detail::MagicOffset + 3] == detail::MagicValue[3]);
+    constexpr size_t data_size = (8 + 1000 * 4) + (8 + 1000 * 4) + 3 * 4 * 2;
+    ASSERT(buffer.size() == detail::DataOffset + data_size);
 
-        // checksum
-        crc32c_t checksum = update_crc32c_checksum(Initial_CRC32C, &buffer[detail::MagicOffset], detail::MagicSize);
-        // 数据长度 = 14 原来的 + 6 (b3 3*2 bytes)
-        checksum = update_crc32c_checksum(checksum, &buffer[detail::DataOffset], 14 + 6);
-        checksum = update_crc32c_checksum(checksum, &buffer[detail::DataLengthOffset], detail::DataLengthSize);
-        ASSERT(*reinterpret_cast<crc32c_t*>(&buffer[detail::ChecksumOffset]) == checksum);
+    // u32s的第一个元素按小端序存储
+    const size_t u32_off = detail::DataOffset + 8 + 1000 * 4 + 8;
+    ASSERT(buffer[u32_off + 0] == 0x04);
+    ASSERT(buffer[u32_off + 1] == 0x03);
+    ASSERT(buffer[u32_off + 2] == 0x02);
+    ASSERT(buffer[u32_off + 3] == 0x01);
 
-        // data length = 20 bytes (0x14)
-        ASSERT(buffer[detail::DataLengthOffset + 0] == 0x14);
-        ASSERT(buffer[detail::DataLengthOffset + 1] == 0x00);
-        ASSERT(buffer[detail::DataLengthOffset + 2] == 0x00);
-        ASSERT(buffer[detail::DataLengthOffset + 3] == 0x00);
+    // grid[1][0] = -4
+    const size_t grid_off = u32_off + 1000 * 4;
+    ASSERT(buffer[grid_off + 8] == 0xFC);
+    ASSERT(buffer[grid_off + 9] == 0xFF);
 
-        // data (little endian)
+    Storage_BulkValues back{};
+    result = deserialize(buffer, back);
+    ASSERT(result);
+    ASSERT(back.floats == storage.floats);
+    ASSERT(back.u32s == storage.u32s);
+    ASSERT(memcmp(back.grid, storage.grid, sizeof(storage.grid)) == 0);
 
-        // uint64_t a = 0x0102030405060708
-        ASSERT(buffer[detail::DataOffset + 0] == 0x08);
-        ASSERT(buffer[detail::DataOffset + 1] == 0x07);
-        ASSERT(buffer[detail::DataOffset + 2] == 0x06);
-        ASSERT(buffer[detail::DataOffset + 3] == 0x05);
-        ASSERT(buffer[detail::DataOffset + 4] == 0x04);
-        ASSERT(buffer[detail::DataOffset + 5] == 0x03);
-        ASSERT(buffer[detail::DataOffset + 6] == 0x02);
-        ASSERT(buffer[detail::DataOffset + 7] == 0x01);
+    // 定长buffer放不下数组时，整个数组都不会写入
+    {
+        std::array<uint8_t, detail::DataOffset + 8 + 100> small{};
+        result = serialize(small, storage);
+        ASSERT(!result);
+        ASSERT(result.code == ResultCode::IncompleteSerialization);
+    }
 
-        // bool b1 = true
-        ASSERT(buffer[detail::DataOffset + 8] == 0x01);
+    // 数组数据被截断
+    {
+        std::vector<uint8_t> truncated(buffer.begin(), buffer.end() - 1);
+        Storage_BulkValues partial{};
+        detail::Header header{};
+        memcpy(&header, truncated.data(), sizeof(header));
+        header.data_length -= 1;
+        header.checksum = update_crc32c_checksum(Initial_CRC32C, truncated.data() + detail::MagicOffset, detail::MagicSize);
+        header.checksum = update_crc32c_checksum(header.checksum, truncated.data() + detail::DataOffset, header.data_length);
+        header.checksum = update_crc32c_checksum(header.checksum, reinterpret_cast<const uint8_t*>(&header.data_length), detail::DataLengthSize);
+        memcpy(truncated.data(), &header, sizeof(header));
+
+        result = deserialize(truncated, partial);
+        ASSERT(!result);
+        ASSERT(result.code == ResultCode::ByteContainerTooSmall);
+    }
 
-        // uint32_t c = 0x11223344
-        ASSERT(buffer[detail::DataOffset + 9]  == 0x44);
-        ASSERT(buffer[detail::DataOffset + 10] == 0x33);
-        ASSERT(buffer[detail::DataOffset + 11] == 0x22);
-        ASSERT(buffer[detail::DataOffset + 12] == 0x11);
+    // 字符串整体拷贝，多字节字符按小端序存储
+    {
+        const std::u32string text = U"\U0001F30D\u4E16";
+        result = serialize(buffer, text);
+        ASSERT(result);
+        ASSERT(buffer.size() == detail::DataOffset + 8 + 2 * 4);
+        ASSERT(buffer[detail::DataOffset + 8 + 0] == 0x0D);
+        ASSERT(buffer[detail::DataOffset + 8 + 1] == 0xF3);
+        ASSERT(buffer[detail::DataOffset + 8 + 2] == 0x01);
+        ASSERT(buffer[detail::DataOffset + 8 + 3] == 0x00);
+
+        std::u32string text_back = U"old";
+        ASSERT(deserialize(buffer, text_back));
+        ASSERT(text_back == text);
+
+        const std::string long_text(100000, 'z');
+        ASSERT(serialize(buffer, long_text));
+        std::string long_back{};
+        ASSERT(deserialize(buffer, long_back));
+        ASSERT(long_back == long_text);
+    }
 
-        // bool b2 = false
-        ASSERT(buffer[detail::DataOffset + 13] == 0x00);
+    // 数据在缓冲区中没有对齐: vector逐个memcpy构造，string退回resize + 整体拷贝
+    {
+        const std::pair<uint8_t, std::vector<uint32_t>> shifted{ 1, storage.u32s };
+        ASSERT(serialize(buffer, shifted));
+        std::pair<uint8_t, std::vector<uint32_t>> shifted_back{ 0, { 9, 9 } };
+        ASSERT(deserialize(buffer, shifted_back));
+        ASSERT(shifted_back == shifted);
+
+        const std::pair<uint8_t, std::u16string> shifted_text{ 1, u"\u4E16\u754C" };
+        ASSERT(serialize(buffer, shifted_text));
+        std::pair<uint8_t, std::u16string> shifted_text_back{};
+        ASSERT(deserialize(buffer, shifted_text_back));
+        ASSERT(shifted_text_back == shifted_text);
+    }
+}
 
-        // bool b3[3][2] = {{1,0},{0,1},{1,1}}
-        ASSERT(buffer[detail::DataOffset + 14] == 0x01);
-        ASSERT(buffer[detail::DataOffset + 15] == 0x00);
-        ASSERT(buffer[detail::DataOffset + 16] == 0x00);
-        ASSERT(buffer[detail::DataOffset + 17] == 0x01);
-        ASSERT(buffer[detail::DataOffset + 18] == 0x01);
-        ASSERT(buffer[detail::DataOffset + 19] == 0x01);
 
-        // sizeof 检查
-        ASSERT(sizeof(Storage_Bool) <= buffer.size());
+// 统计分配次数，用来检查预留容量之后没有再次扩容(vector::reserve只保证容量不小于请求的大小)
+template<typename T>
+struct Storage_CountingAllocator
+{
+    using value_type = T;
 
-        // 反序列化测试
-        Storage_Bool back{ 0, false, 0, true, {} };
-        auto result = infra::binary_serialization::deserialize(buffer, back);
+    size_t* allocations = nullptr;
 
-        ASSERT(result);
-        ASSERT(result.code == ResultCode::OK);
+    explicit Storage_CountingAllocator(size_t* count) noexcept
+        : allocations(count)
+    {
+    }
 
-        ASSERT(back.a  == 0x0102030405060708ULL);
-        ASSERT(back.b1 == true);
-        ASSERT(back.c  == 0x11223344);
-        ASSERT(back.b2 == false);
+    template<typename U>
+    Storage_CountingAllocator(const Storage_CountingAllocator<U>& other) noexcept
+        : allocations(other.allocations)
+    {
+    }
 
-        ASSERT(back.b3[0][0] == true);
-        ASSERT(back.b3[0][1] == false);
-        ASSERT(back.b3[1][0] == false);
-        ASSERT(back.b3[1][1] == true);
-        ASSERT(back.b3[2][0] == true);
-        ASSERT(back.b3[2][1] == true);
+    T* allocate(size_t n)
+    {
+        ++*allocations;
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept
+    {
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template<typename U>
+    bool operator==(const Storage_CountingAllocator<U>& other) const noexcept
+    {
+        return allocations == other.allocations;
     }
+};
+
+// size_hint只影响预留的容量，不影响序列化结果
+void size_hint_test()
+{
+    using namespace infra::binary_serialization;
+
+    std::vector<Storage> storage{};
+    for (uint32_t i = 0; i < 4096; ++i)
+    {
+        storage.push_back(Storage{ i, i + 1, i + 2 });
+    }
+
+    std::vector<uint8_t> expected{};
+    auto result = serialize(expected, storage);
+    ASSERT(result);
+    ASSERT(expected.size() == detail::DataOffset + 8 + 4096 * 16);
+
+    size_t allocations = 0;
+    std::vector<uint8_t, Storage_CountingAllocator<uint8_t>> buffer(Storage_CountingAllocator<uint8_t>{ &allocations });
+    SerializeOptions options{};
+    options.size_hint = expected.size();
+    result = serialize(buffer, storage, options);
+    ASSERT(result);
+    ASSERT(std::ranges::equal(buffer, expected));
+    ASSERT(buffer.capacity() >= expected.size());
+    ASSERT(allocations == 1); // 预留的容量够用，没有发生扩容
+
+    std::vector<Storage> back{};
+    result = deserialize(buffer, back);
+    ASSERT(result);
+    ASSERT(back == storage);
 }
 
 
-struct Storage_SubFile
+// 计数pass得到的大小必须和真实序列化的结果完全一致
+void exact_size_test()
 {
-    std::string str;
-    std::map<std::string, std::pair<uint32_t, bool>> map;
+    using namespace infra::binary_serialization;
+
+    Storage_CustomStruct storage{};
+    storage.std_u8string = u8"exact size";
+    storage.std_vector_1 = { Storage{1, 2, 3}, Storage{4, 5, 6} };
+    storage.map_1[u8"key"] = Storage{7, 8, 9};
+
+    size_t size = 0;
+    auto result = serialized_size(storage, size);
+    ASSERT(result);
+
+    size_t allocations = 0;
+    std::vector<uint8_t, Storage_CountingAllocator<uint8_t>> buffer(Storage_CountingAllocator<uint8_t>{ &allocations });
+    SerializeOptions options{};
+    options.exact_size = true;
+    result = serialize(buffer, storage, options);
+    ASSERT(result);
+    ASSERT(buffer.size() == size);
+    ASSERT(buffer.capacity() >= size);
+    ASSERT(allocations == 1); // 只分配了一次
+
+    Storage_CustomStruct back{};
+    result = deserialize(buffer, back);
+    ASSERT(result);
+    ASSERT(back.std_u8string == storage.std_u8string);
+    ASSERT(back.std_vector_1 == storage.std_vector_1);
+
+    // 计数pass中用户abort，serialize直接返回错误
+    {
+        Storage_UserAbort abort_storage{};
+        size_t abort_size = 0;
+        result = serialized_size(abort_storage, abort_size);
+        ASSERT(!result);
+        ASSERT(result.code == ResultCode::UserAbort);
+
+        std::vector<uint8_t> abort_buffer{};
+        result = serialize(abort_buffer, abort_storage, options);
+        ASSERT(result.code == ResultCode::UserAbort);
+    }
+}
+
+
+// 与Storage字段相同，只包含定长字段，声明后Writer/Reader对整个结构体只做一次边界检查
+struct Storage_Fixed
+{
+    uint64_t a = 0;
+    uint32_t b = 0;
+    uint32_t c = 0;
+
+    bool operator==(const Storage_Fixed&) const = default;
 };
 
 namespace infra::binary_serialization
 {
+    template<>
+    struct fixed_serialized_size<Storage_Fixed> : fixed_serialized_size_sum<uint64_t, uint32_t, uint32_t> {};
+
     template<typename ByteContainer>
     void from_bytes(
         Reader<ByteContainer>& reader,
-        Storage_SubFile& storage
+        Storage_Fixed& storage
     )
     {
-        reader >> storage.str;
-        reader >> storage.map;
+        reader >> storage.a;
+        reader >> storage.b;
+        reader >> storage.c;
     }
 
     template<typename ByteContainer>
     void to_bytes(
         Writer<ByteContainer>& writer,
-        const Storage_SubFile& storage
+        const Storage_Fixed& storage
     )
     {
-        writer << storage.str;
-        writer << storage.map;
+        writer << storage.a;
+        writer << storage.b;
+        writer << storage.c;
     }
 }
 
-struct Storage_File
+void fixed_size_test()
 {
-    // 1. bool变量 + bool C数组
-    bool flag1;
-    bool flag2;
-    bool arr_bool[2][3];
+    using namespace infra::binary_serialization;
 
-    // 2. 整型变量及C数组
-    uint32_t u32;
-    int64_t i64;
-    uint16_t u16;
+    static_assert(fixed_serialized_size_v<uint32_t> == 4);
+    static_assert(fixed_serialized_size_v<const bool> == 1);
+    static_assert(fixed_serialized_size_v<bool[3][2]> == 6);
+    static_assert(fixed_serialized_size_v<int16_t[2][3]> == 12);
+    static_assert(fixed_serialized_size_v<Storage_Fixed> == 16);
+    static_assert(fixed_serialized_size_v<Storage_Fixed[2][3]> == 96);
+    static_assert(fixed_serialized_size_v<std::pair<Storage_Fixed, bool>> == 17);
+    static_assert(fixed_serialized_size_v<Storage_Structure> == 0);
+    static_assert(fixed_serialized_size_v<std::vector<uint32_t>> == 0);
+    static_assert(fixed_serialized_size_sum<Storage_Fixed, std::vector<uint32_t>>::value == 0);
+
+    // 定长结构体数组
+    {
+        std::vector<std::pair<Storage_Fixed, bool>> storage{};
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            storage.emplace_back(Storage_Fixed{ i, i * 2, i * 3 }, (i % 2) == 0);
+        }
+
+        std::vector<uint8_t> buffer{};
+        auto result = serialize(buffer, storage);
+        ASSERT(result);
+        ASSERT(buffer.size() == detail::DataOffset + 8 + 100 * 17);
+
+        std::vector<std::pair<Storage_Fixed, bool>> back{};
+        result = deserialize(buffer, back);
+        ASSERT(result);
+        ASSERT(back == storage);
+    }
+
+    // 容器刚好放得下
+    {
+        Storage_Fixed storage{ 1, 2, 3 };
+        std::array<uint8_t, detail::DataOffset + 16> buffer{};
+        auto result = serialize(buffer, storage);
+        ASSERT(result);
+
+        Storage_Fixed back{};
+        result = deserialize(buffer, back);
+        ASSERT(result);
+        ASSERT(back == storage);
+    }
+}
+
+// 与Storage_Tick字段完全相同，但走to_bytes/from_bytes，用于对比编码结果
+struct Storage_TickFields
+{
+    double price;
+    uint64_t timestamp;
+    int32_t quantity;
+    uint32_t flags;
+};
+
+namespace infra::binary_serialization
+{
+    template<typename ByteContainer>
+    void from_bytes(
+        Reader<ByteContainer>& reader,
+        Storage_TickFields& storage
+    )
+    {
+        reader >> storage.price;
+        reader >> storage.timestamp;
+        reader >> storage.quantity;
+        reader >> storage.flags;
+    }
+
+    template<typename ByteContainer>
+    void to_bytes(
+        Writer<ByteContainer>& writer,
+        const Storage_TickFields& storage
+    )
+    {
+        writer << storage.price;
+        writer << storage.timestamp;
+        writer << storage.quantity;
+        writer << storage.flags;
+    }
+}
+
+// 包含double，需要通过fixed_serialized_size声明没有padding
+struct Storage_Tick
+{
+    double price;
+    uint64_t timestamp;
+    int32_t quantity;
+    uint32_t flags;
+
+    bool operator==(const Storage_Tick&) const = default;
+};
+
+namespace infra::binary_serialization
+{
+    template<>
+    struct enable_memcpy_serialization<Storage_Tick> : std::true_type {};
+
+    template<>
+    struct fixed_serialized_size<Storage_Tick> : fixed_serialized_size_sum<double, uint64_t, int32_t, uint32_t> {};
+
+    template<typename ByteContainer>
+    void from_bytes(
+        Reader<ByteContainer>& reader,
+        Storage_Tick& storage
+    )
+    {
+        reader >> storage.price;
+        reader >> storage.timestamp;
+        reader >> storage.quantity;
+        reader >> storage.flags;
+    }
+
+    template<typename ByteContainer>
+    void to_bytes(
+        Writer<ByteContainer>& writer,
+        const Storage_Tick& storage
+    )
+    {
+        writer << storage.price;
+        writer << storage.timestamp;
+        writer << storage.quantity;
+        writer << storage.flags;
+    }
+}
+
+// 只包含整数，满足has_unique_object_representations
+struct Storage_Point
+{
+    int32_t x;
+    int32_t y;
+    uint16_t tag[2];
+
+    bool operator==(const Storage_Point&) const = default;
+};
+
+namespace infra::binary_serialization
+{
+    template<>
+    struct enable_memcpy_serialization<Storage_Point> : std::true_type {};
+
+    template<typename ByteContainer>
+    void from_bytes(
+        Reader<ByteContainer>& reader,
+        Storage_Point& storage
+    )
+    {
+        reader >> storage.x;
+        reader >> storage.y;
+        reader >> storage.tag;
+    }
+
+    template<typename ByteContainer>
+    void to_bytes(
+        Writer<ByteContainer>& writer,
+        const Storage_Point& storage
+    )
+    {
+        writer << storage.x;
+        writer << storage.y;
+        writer << storage.tag;
+    }
+}
+
+void memcpy_structure_test()
+{
+    using namespace infra::binary_serialization;
+
+    static_assert(is_memcpy_structure<Storage_Tick>);
+    static_assert(is_memcpy_structure<const Storage_Point>);
+    static_assert(!is_memcpy_structure<Storage_TickFields>);
+    static_assert(!is_memcpy_structure<Storage>);
+    static_assert(fixed_serialized_size_v<Storage_Tick> == 24);
+    static_assert(fixed_serialized_size_v<Storage_Point> == 12);
+    static_assert(fixed_serialized_size_v<Storage_Point[3]> == 36);
+
+    // 编码结果与逐字段写入完全相同
+    {
+        std::vector<Storage_Tick> ticks{};
+        std::vector<Storage_TickFields> fields{};
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            ticks.push_back(Storage_Tick{ i * 0.25, 1700000000000ull + i, -static_cast<int32_t>(i), i * 7 });
+            fields.push_back(Storage_TickFields{ i * 0.25, 1700000000000ull + i, -static_cast<int32_t>(i), i * 7 });
+        }
+
+        std::vector<uint8_t> buffer{};
+        auto result = serialize(buffer, ticks);
+        ASSERT(result);
+        ASSERT(buffer.size() == detail::DataOffset + 8 + 100 * 24);
+
+        std::vector<uint8_t> expected{};
+        result = serialize(expected, fields);
+        ASSERT(result);
+        ASSERT(buffer == expected);
+
+        std::vector<Storage_Tick> back{};
+        result = deserialize(buffer, back);
+        ASSERT(result);
+        ASSERT(back == ticks);
+    }
+
+    // 单个结构体、C数组、嵌套在pair中
+    {
+        std::pair<Storage_Point, Storage_Tick> storage{ Storage_Point{ 1, -2, { 3, 4 } }, Storage_Tick{ 1.5, 2, 3, 4 } };
+        std::vector<uint8_t> buffer{};
+        auto result = serialize(buffer, storage);
+        ASSERT(result);
+        ASSERT(buffer.size() == detail::DataOffset + 12 + 24);
+
+        std::pair<Storage_Point, Storage_Tick> back{};
+        result = deserialize(buffer, back);
+        ASSERT(result);
+        ASSERT(back == storage);
+
+        Storage_Point points[3] = { { 1, 2, { 3, 4 } }, { 5, 6, { 7, 8 } }, { 9, 10, { 11, 12 } } };
+        buffer.clear();
+        result = serialize(buffer, points);
+        ASSERT(result);
+        ASSERT(buffer.size() == detail::DataOffset + 36);
+
+        Storage_Point points_back[3]{};
+        result = deserialize(buffer, points_back);
+        ASSERT(result);
+        ASSERT(std::equal(std::begin(points), std::end(points), std::begin(points_back)));
+    }
+
+    // 数据不足
+    {
+        Storage_Point storage{ 1, 2, { 3, 4 } };
+        std::vector<uint8_t> buffer{};
+        auto result = serialize(buffer, storage);
+        ASSERT(result);
+
+        Storage_Tick back{};
+        result = deserialize(buffer, back);
+        ASSERT(!result);
+    }
+}
+
+// 定长结构体 + 长度为i % length_mod的字符串，fill为0时每条记录的字符不同
+std::vector<std::pair<Storage, std::string>> make_records(uint32_t count, uint32_t length_mod, char fill = 0)
+{
+    std::vector<std::pair<Storage, std::string>> records{};
+    records.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const char c = fill != 0 ? fill : static_cast<char>('a' + i % 26);
+        records.emplace_back(Storage{ i, i * 3, i * 7 }, std::string(i % length_mod, c));
+    }
+    return records;
+}
+
+// 读取时越过数据区，用来检查增量校验的回退路径
+struct Storage_OverRead
+{
+    std::vector<uint32_t> a;
+    uint8_t tail[20000];
+};
+
+namespace infra::binary_serialization
+{
+    template<typename ByteContainer>
+    void from_bytes(
+        Reader<ByteContainer>& reader,
+        Storage_OverRead& storage
+    )
+    {
+        reader >> storage.a;
+        reader >> storage.tail;
+    }
+}
+
+void fused_checksum_test()
+{
+    using namespace infra::binary_serialization;
+
+    const auto storage = make_records(5000, 17);
+
+    // 编码结果与两遍计算完全相同
+    std::vector<uint8_t> buffer{};
+    auto result = serialize(buffer, storage, { .fused_checksum = true });
+    ASSERT(result);
+    ASSERT(buffer.size() > 4 * detail::FusedChecksumChunkSize);
+
+    std::vector<uint8_t> expected{};
+    result = serialize(expected, storage);
+    ASSERT(result);
+    ASSERT(buffer == expected);
+
+    // 固定大小容器
+    {
+        std::array<uint8_t, 16> small{};
+        result = serialize(small, Storage{ 1, 2, 3 }, { .fused_checksum = true });
+        ASSERT(!result);
+
+        std::array<uint8_t, detail::DataOffset + 16> exact{};
+        result = serialize(exact, Storage{ 1, 2, 3 }, { .fused_checksum = true });
+        ASSERT(result);
+
+        Storage back{};
+        result = deserialize(exact, back, { .fused_checksum = true });
+        ASSERT(result);
+        ASSERT((back == Storage{ 1, 2, 3 }));
+    }
+
+    // 增量校验读取
+    {
+        std::vector<std::pair<Storage, std::string>> back{};
+        result = deserialize(buffer, back, { .fused_checksum = true });
+        ASSERT(result);
+        ASSERT(back == storage);
+    }
+
+    // 数据损坏: 校验失败优先报告
+    {
+        auto broken = buffer;
+        broken[broken.size() / 2] ^= 0x01;
+
+        std::vector<std::pair<Storage, std::string>> back{};
+        result = deserialize(broken, back, { .fused_checksum = true });
+        ASSERT(result.code == ResultCode::ChecksumIncorrect);
+    }
+
+    // 读取越过数据区: 与非增量模式的结果一致
+    {
+        std::vector<uint8_t> over{};
+        result = serialize(over, std::vector<uint32_t>{ 1, 2, 3 });
+        ASSERT(result);
+        over.resize(over.size() + sizeof(Storage_OverRead::tail), 0xAB);
+
+        Storage_OverRead back{};
+        result = deserialize(over, back, { .fused_checksum = true });
+        ASSERT(result);
+        ASSERT((back.a == std::vector<uint32_t>{ 1, 2, 3 }));
+        ASSERT(back.tail[0] == 0xAB && back.tail[sizeof(back.tail) - 1] == 0xAB);
+    }
+}
+
+std::vector<uint8_t> read_whole_file(FILE* file)
+{
+    std::vector<uint8_t> content{};
+    std::fseek(file, 0, SEEK_END);
+    content.resize(static_cast<size_t>(std::ftell(file)));
+    std::fseek(file, 0, SEEK_SET);
+    const size_t n = std::fread(content.data(), 1, content.size(), file);
+    content.resize(n);
+    return content;
+}
+
+void stream_sink_test()
+{
+    using namespace infra::binary_serialization;
+
+    const auto storage = make_records(3000, 23);
+    std::vector<uint32_t> numbers(5000);
+    for (uint32_t i = 0; i < numbers.size(); ++i)
+    {
+        numbers[i] = i * 2654435761u;
+    }
+
+    std::vector<uint8_t> expected_storage{};
+    ASSERT(serialize(expected_storage, storage));
+    std::vector<uint8_t> expected_numbers{};
+    ASSERT(serialize(expected_numbers, numbers));
+
+    // FILE*: 很小的块，强制频繁输出；批量数据跨越多个块
+    {
+        FILE* file = std::tmpfile();
+        ASSERT(file != nullptr);
+        std::fputs("prefix", file); // 文件中已有数据，header回填的位置需要相对于sink创建时的位置
+
+        {
+            FileSink sink(file, 100);
+            ASSERT(serialize(sink, storage));
+            ASSERT(serialize(sink, numbers));
+            ASSERT(sink.written() == expected_storage.size() + expected_numbers.size());
+            ASSERT(sink.buffer().capacity() <= 1024);
+        }
+
+        const auto content = read_whole_file(file);
+        std::fclose(file);
+
+        ASSERT(content.size() == 6 + expected_storage.size() + expected_numbers.size());
+        ASSERT(std::equal(expected_storage.begin(), expected_storage.end(), content.begin() + 6));
+        ASSERT(std::equal(expected_numbers.begin(), expected_numbers.end(), content.begin() + 6 + expected_storage.size()));
+    }
+
+#if !INFRA_OS_WINDOWS
+    // fd
+    {
+        FILE* file = std::tmpfile();
+        ASSERT(file != nullptr);
+
+        {
+            FdSink sink(fileno(file), 4096);
+            ASSERT(serialize(sink, storage));
+        }
+
+        const auto content = read_whole_file(file);
+        std::fclose(file);
+        ASSERT(content == expected_storage);
+
+        std::vector<std::pair<Storage, std::string>> back{};
+        ASSERT(deserialize(content, back));
+        ASSERT(back == storage);
+    }
+
+    // 写入失败
+    {
+        FdSink sink(-1, 4096);
+        auto result = serialize(sink, storage);
+        ASSERT(result.code == ResultCode::StreamWriteFailed);
+    }
+#endif
+}
+
+void mapped_file_writer_test()
+{
+    using namespace infra::binary_serialization;
+    namespace fs = std::filesystem;
+
+    const std::string path = (fs::path(INFRA_TEST_EXE_DIR) / "mapped_writer.bin").string();
+
+    // 超过初始容量，需要多次扩大文件并重新映射
+    std::vector<uint32_t> numbers(600000);
+    for (uint32_t i = 0; i < numbers.size(); ++i)
+    {
+        numbers[i] = i * 2654435761u;
+    }
+    const auto storage = make_records(300, 23);
+
+    std::vector<uint8_t> expected{};
+    ASSERT(serialize(expected, numbers));
+
+    {
+        MappedFileWriter file{};
+        ASSERT(file.open(path.c_str()));
+
+        // 先写一个小对象，再覆盖为大对象
+        ASSERT(serialize(file, storage));
+        ASSERT(serialize(file, numbers));
+        ASSERT(file.size() == expected.size());
+        ASSERT(file.capacity() >= file.size());
+        ASSERT(std::equal(expected.begin(), expected.end(), file.data()));
+        ASSERT(file.sync());
+
+        // 移动后由新对象负责截断和关闭
+        MappedFileWriter moved = std::move(file);
+        ASSERT(!file.is_open());
+        ASSERT(moved.is_open());
+        ASSERT(moved.size() == expected.size());
+        ASSERT(moved.close());
+    }
+
+    // close后文件被截断到实际大小
+    ASSERT(fs::file_size(path) == expected.size());
+
+    {
+        MappedFile mapped{};
+        ASSERT(mapped.open(path.c_str()));
+
+        std::vector<uint32_t> back{};
+        ASSERT(deserialize(mapped, back));
+        ASSERT(back == numbers);
+    }
+
+    fs::remove(path);
+}
+
+void span_test()
+{
+    using namespace infra::binary_serialization;
+
+    const auto storage = make_records(50, 13);
+    const std::vector<uint32_t> numbers{ 1, 2, 3, 0xFFFFFFFF };
+
+    std::vector<uint8_t> expected_storage{};
+    auto result = serialize(expected_storage, storage);
+    ASSERT(result);
+    ASSERT(result.bytes == expected_storage.size());
+
+    // 在一块大缓冲区中连续写入两个对象，不分配中间内存
+    std::vector<uint8_t> buffer(4096, 0xCD);
+    std::span<uint8_t> region(buffer.data() + 8, buffer.size() - 8);
+
+    result = serialize(region, storage);
+    ASSERT(result);
+    ASSERT(result.bytes == expected_storage.size());
+    ASSERT(std::equal(expected_storage.begin(), expected_storage.end(), buffer.begin() + 8));
+    ASSERT(buffer[8 + result.bytes] == 0xCD);
+
+    std::span<uint8_t> next = region.subspan(result.bytes);
+    const auto second = serialize(next, numbers);
+    ASSERT(second);
+
+    // 只读span，按Result::bytes依次解码
+    std::span<const std::byte> in = std::as_bytes(region);
+
+    std::vector<std::pair<Storage, std::string>> storage_back{};
+    result = deserialize(in, storage_back);
+    ASSERT(result);
+    ASSERT(storage_back == storage);
+
+    std::vector<uint32_t> numbers_back{};
+    const auto second_back = deserialize(in.subspan(result.bytes), numbers_back);
+    ASSERT(second_back);
+    ASSERT(second_back.bytes == second.bytes);
+    ASSERT(numbers_back == numbers);
+
+    // 区域不够大
+    std::span<uint8_t> small(buffer.data(), 20);
+    ASSERT(serialize(small, storage).code == ResultCode::IncompleteSerialization);
+
+    std::span<const uint8_t> truncated(expected_storage.data(), expected_storage.size() - 1);
+    ASSERT(deserialize(truncated, storage_back).code == ResultCode::ByteContainerTooSmall);
+}
+
+template<typename ByteContainer, typename Object>
+concept can_deserialize_from = requires(ByteContainer&& byte_array, Object& object)
+{
+    infra::binary_serialization::deserialize(std::forward<ByteContainer>(byte_array), object);
+};
+
+void view_test()
+{
+    using namespace infra::binary_serialization;
+
+    // 视图不能指向临时容器
+    static_assert(!can_deserialize_from<std::vector<uint8_t>, std::string_view>);
+    static_assert(!can_deserialize_from<std::vector<uint8_t>, std::vector<std::pair<uint32_t, std::span<const uint16_t>>>>);
+    static_assert(can_deserialize_from<std::vector<uint8_t>&, std::string_view>);
+    static_assert(can_deserialize_from<std::span<const uint8_t>, std::string_view>);
+    static_assert(can_deserialize_from<std::vector<uint8_t>, std::string>);
+
+    // 与std::basic_string、std::vector的编码相同，可以互相读写
+    const std::vector<std::string> names{ "alpha", "", "gamma delta", std::string(1000, 'x') };
+    std::vector<uint8_t> bytes{};
+    ASSERT(serialize(bytes, names));
+
+    std::vector<std::string_view> views{};
+    ASSERT(deserialize(bytes, views));
+    ASSERT(views.size() == names.size());
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        ASSERT(views[i] == names[i]);
+        // 指向源缓冲区
+        ASSERT(views[i].empty() || (reinterpret_cast<const uint8_t*>(views[i].data()) >= bytes.data() &&
+            reinterpret_cast<const uint8_t*>(views[i].data()) < bytes.data() + bytes.size()));
+    }
+
+    std::vector<uint8_t> bytes2{};
+    ASSERT(serialize(bytes2, views));
+    ASSERT(bytes2 == bytes);
+
+    // 多字节元素
+    const std::u16string text = u"你好, world";
+    ASSERT(serialize(bytes, text));
+    std::u16string_view text_view{};
+    ASSERT(deserialize(bytes, text_view));
+    ASSERT(text_view == text);
+
+    const std::vector<uint32_t> numbers{ 1, 2, 0xDEADBEEF, 4 };
+    ASSERT(serialize(bytes, numbers));
+    std::span<const uint32_t> number_view{};
+    ASSERT(deserialize(bytes, number_view, DeserializeOptions{ .fused_checksum = true }));
+    ASSERT(std::equal(number_view.begin(), number_view.end(), numbers.begin(), numbers.end()));
+
+    ASSERT(serialize(bytes2, number_view));
+    ASSERT(bytes2 == bytes);
+
+    // 8字节元素: V1 header(12字节) + 长度前缀(8字节)之后只有4字节对齐，V2 header(24字节)之后是8字节对齐
+    const std::vector<double> prices{ 1.5, -2.25, 1e300 };
+    ASSERT(serialize(bytes, prices, SerializeOptions{ .header_version = HeaderVersion::V2 }));
+    std::span<const double> price_view{};
+    ASSERT(deserialize(bytes, price_view));
+    ASSERT(std::equal(price_view.begin(), price_view.end(), prices.begin(), prices.end()));
+
+    ASSERT(serialize(bytes, prices));
+    ASSERT(deserialize(bytes, price_view).code == ResultCode::UnalignedView);
+
+    // 没有对齐
+    const std::pair<uint8_t, std::vector<uint32_t>> shifted{ 7, numbers };
+    ASSERT(serialize(bytes, shifted));
+    std::pair<uint8_t, std::span<const uint32_t>> shifted_view{};
+    ASSERT(deserialize(bytes, shifted_view).code == ResultCode::UnalignedView);
+
+    // 长度超出数据范围
+    const std::vector<uint8_t> raw{ 100, 0, 0, 0, 0, 0, 0, 0, 0xAB, 0xAB };
+    Reader<std::vector<uint8_t>> reader(raw);
+    std::span<const uint8_t> blob_view{};
+    reader >> blob_view;
+    ASSERT(reader.result() == ResultCode::LengthExceedsData);
+    ASSERT(blob_view.empty());
+}
+
+// 什么都不写的标记结构体
+struct Storage_Empty
+{
+    bool operator==(const Storage_Empty&) const = default;
+};
+
+namespace infra::binary_serialization
+{
+    template<typename ByteContainer>
+    void from_bytes(
+        Reader<ByteContainer>&,
+        Storage_Empty&
+    )
+    {
+    }
+
+    template<typename ByteContainer>
+    void to_bytes(
+        Writer<ByteContainer>&,
+        const Storage_Empty&
+    )
+    {
+    }
+}
+
+void length_prefix_test()
+{
+    using namespace infra::binary_serialization;
+
+    // 长度前缀为2^40，数据只有1KB: 必须在分配内存之前失败
+    std::vector<uint8_t> raw(1024, 0x5A);
+    const uint64_t huge = uint64_t(1) << 40;
+    memcpy(raw.data(), &huge, sizeof(huge));
+    infra::endian::to_little(raw.data(), sizeof(huge));
+
+    {
+        Reader<std::vector<uint8_t>> reader(raw);
+        std::vector<uint32_t> v{};
+        reader >> v;
+        ASSERT(reader.result() == ResultCode::LengthExceedsData);
+        ASSERT(v.empty());
+    }
+    {
+        Reader<std::vector<uint8_t>> reader(raw);
+        std::string str{};
+        reader >> str;
+        ASSERT(reader.result() == ResultCode::LengthExceedsData);
+    }
+    {
+        Reader<std::vector<uint8_t>> reader(raw);
+        std::vector<std::string> strs{};
+        reader >> strs;
+        ASSERT(reader.result() == ResultCode::LengthExceedsData);
+    }
+    {
+        Reader<std::vector<uint8_t>> reader(raw);
+        std::map<uint32_t, std::string> m{};
+        reader >> m;
+        ASSERT(reader.result() == ResultCode::LengthExceedsData);
+    }
+
+    // 每个元素至少8字节(长度前缀): 1016字节最多容纳127个字符串
+    {
+        const uint64_t count = (raw.size() - 8) / 8 + 1;
+        memcpy(raw.data(), &count, sizeof(count));
+        infra::endian::to_little(raw.data(), sizeof(count));
+
+        Reader<std::vector<uint8_t>> reader(raw);
+        std::vector<std::string> strs{};
+        reader >> strs;
+        ASSERT(reader.result() == ResultCode::LengthExceedsData);
+    }
+
+    // 刚好放得下时正常读取
+    {
+        const std::vector<uint16_t> v(100, 0xBEEF);
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, v));
+        std::vector<uint16_t> back{};
+        ASSERT(deserialize(bytes, back));
+        ASSERT(back == v);
+    }
+
+    // varint长度前缀至少1字节: 1000个空字符串只占1000多字节
+    {
+        const std::vector<std::string> empty_strs(1000);
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, empty_strs, SerializeOptions{ .compact_length = true }));
+        std::vector<std::string> back{};
+        ASSERT(deserialize(bytes, back));
+        ASSERT(back == empty_strs);
+    }
+
+    // 定长结构体按fixed_serialized_size检查
+    {
+        const std::vector<Storage_Fixed> v(10, Storage_Fixed{ 1, 2, 3 });
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, v));
+        std::vector<Storage_Fixed> back{};
+        ASSERT(deserialize(bytes, back));
+        ASSERT(back == v);
+    }
+
+    // 不占任何字节的元素不限制数量
+    {
+        const std::vector<Storage_Empty> v(1000);
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, v));
+        std::vector<Storage_Empty> back{};
+        ASSERT(deserialize(bytes, back));
+        ASSERT(back.size() == v.size());
+    }
+
+    // varint每个至少1字节
+    {
+        std::vector<uint8_t> bytes(sizeof(uint64_t) + 100, 0x01);
+        const uint64_t count = 101;
+        memcpy(bytes.data(), &count, sizeof(count));
+        infra::endian::to_little(bytes.data(), sizeof(count));
+
+        Reader<std::vector<uint8_t>> reader(bytes);
+        std::vector<Varint<uint32_t>> back{};
+        reader >> back;
+        ASSERT(reader.result() == ResultCode::LengthExceedsData);
+    }
+
+    // 只按数据区检查，容器中数据区之后的字节不算在内
+    {
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, uint64_t{ 100 }));
+        bytes.resize(bytes.size() + 1000, 0);
+        std::vector<uint8_t> back{};
+        ASSERT(deserialize(bytes, back).code == ResultCode::LengthExceedsData);
+    }
+}
+
+struct Storage_Varint
+{
+    infra::binary_serialization::Varint<uint64_t> id;
+    infra::binary_serialization::Varint<int32_t> delta;
+    std::vector<infra::binary_serialization::Varint<uint32_t>> counts;
+    std::vector<std::string> names;
+
+    bool operator==(const Storage_Varint&) const = default;
+};
+
+namespace infra::binary_serialization
+{
+    template<typename ByteContainer>
+    void from_bytes(
+        Reader<ByteContainer>& reader,
+        Storage_Varint& storage
+    )
+    {
+        reader >> storage.id;
+        reader >> storage.delta;
+        reader >> storage.counts;
+        reader >> storage.names;
+    }
+
+    template<typename ByteContainer>
+    void to_bytes(
+        Writer<ByteContainer>& writer,
+        const Storage_Varint& storage
+    )
+    {
+        writer << storage.id;
+        writer << storage.delta;
+        writer << storage.counts;
+        writer << storage.names;
+    }
+}
+
+void varint_test()
+{
+    using namespace infra::binary_serialization;
+
+    // 编码
+    {
+        uint8_t buffer[detail::MaxVarintSize]{};
+        ASSERT(detail::encode_varint(0, buffer) == 1 && buffer[0] == 0);
+        ASSERT(detail::encode_varint(127, buffer) == 1 && buffer[0] == 127);
+        ASSERT(detail::encode_varint(300, buffer) == 2 && buffer[0] == 0xAC && buffer[1] == 0x02);
+        ASSERT(detail::encode_varint(UINT64_MAX, buffer) == 10 && buffer[9] == 0x01);
+
+        ASSERT(detail::zigzag_encode(0) == 0);
+        ASSERT(detail::zigzag_encode(-1) == 1);
+        ASSERT(detail::zigzag_encode(1) == 2);
+        ASSERT(detail::zigzag_encode(INT64_MIN) == UINT64_MAX);
+        ASSERT(detail::zigzag_decode(UINT64_MAX) == INT64_MIN);
+    }
+
+    // 标量和pext解码结果一致
+    {
+        std::mt19937_64 rng(42);
+        uint8_t buffer[detail::MaxVarintSize + 8]{};
+        for (int i = 0; i < 100000; ++i)
+        {
+            const uint64_t v = rng() >> (rng() % 64);
+            const size_t n = detail::encode_varint(v, buffer);
+
+            uint64_t scalar = 0;
+            ASSERT(detail::decode_varint_scalar(buffer, sizeof(buffer), scalar) == n);
+            ASSERT(scalar == v);
+
+            uint64_t fast = 0;
+            ASSERT(detail::decode_varint(buffer, sizeof(buffer), fast) == n);
+            ASSERT(fast == v);
+
+        #if INFRA_ARCH_X86_64
+            if (detail::support_fast_pext())
+            {
+                uint64_t pext = 0;
+                ASSERT(detail::decode_varint_bmi2(buffer, sizeof(buffer), pext) == n);
+                ASSERT(pext == v);
+            }
+        #endif
+        }
+    }
+
+    Storage_Varint storage{};
+    storage.id.value = 123456789012345ull;
+    storage.delta.value = -3;
+    for (uint32_t i = 0; i < 200; ++i)
+    {
+        storage.counts.push_back({ i * i });
+        storage.names.push_back(std::string(i % 7, 'n'));
+    }
+
+    // compact_length: 长度前缀只占1~2字节
+    std::vector<uint8_t> normal{};
+    ASSERT(serialize(normal, storage));
+    std::vector<uint8_t> compact{};
+    ASSERT(serialize(compact, storage, SerializeOptions{ .compact_length = true }));
+    ASSERT(compact.size() + 200 * 7 <= normal.size());
+
+    size_t counted = 0;
+    ASSERT(serialized_size(storage, counted, SerializeOptions{ .compact_length = true }));
+    ASSERT(counted == compact.size());
+
+    Storage_Varint back{};
+    ASSERT(deserialize(normal, back));
+    ASSERT(back == storage);
+
+    back = {};
+    ASSERT(deserialize(compact, back, DeserializeOptions{ .fused_checksum = true }));
+    ASSERT(back == storage);
+
+    // 超出目标类型的范围
+    {
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, Varint<uint32_t>{ 300 }));
+        Varint<uint8_t> narrow{};
+        ASSERT(deserialize(bytes, narrow).code == ResultCode::InvalidVarint);
+
+        ASSERT(serialize(bytes, Varint<int64_t>{ -200 }));
+        Varint<int8_t> narrow_signed{};
+        ASSERT(deserialize(bytes, narrow_signed).code == ResultCode::InvalidVarint);
+        Varint<int16_t> wide_signed{};
+        ASSERT(deserialize(bytes, wide_signed));
+        ASSERT(wide_signed.value == -200);
+    }
+
+    // 超过10字节
+    {
+        const std::vector<uint8_t> raw(16, 0xFF);
+        Reader<std::vector<uint8_t>> reader(raw);
+        Varint<uint64_t> v{};
+        reader >> v;
+        ASSERT(reader.result() == ResultCode::InvalidVarint);
+    }
+
+    // 数据不完整
+    {
+        const std::vector<uint8_t> raw{ 0x80, 0x80 };
+        Reader<std::vector<uint8_t>> reader(raw);
+        Varint<uint64_t> v{};
+        reader >> v;
+        ASSERT(reader.result() == ResultCode::ByteContainerTooSmall);
+    }
+}
+
+void header_v2_test()
+{
+    using namespace infra::binary_serialization;
+
+    const auto storage = make_records(100, 11, 'v');
+
+    std::vector<uint8_t> v1{};
+    ASSERT(serialize(v1, storage));
+
+    std::vector<uint8_t> v2{};
+    auto result = serialize(v2, storage, SerializeOptions{ .header_version = HeaderVersion::V2 });
+    ASSERT(result);
+    ASSERT(result.bytes == v2.size());
+    ASSERT(v2.size() == v1.size() - detail::DataOffset + detail::DataOffsetV2);
+    ASSERT(memcmp(v2.data(), detail::MagicValueV2, detail::MagicSize) == 0);
+    ASSERT(std::equal(v1.begin() + detail::DataOffset, v1.end(), v2.begin() + detail::DataOffsetV2));
+
+    detail::HeaderV2 header{};
+    memcpy(&header, v2.data(), sizeof(header));
+    ASSERT(header.flags == 0);
+    ASSERT(header.data_length == v2.size() - detail::DataOffsetV2);
+    ASSERT(header.reserved == 0);
+
+    // 两种header都能读取
+    std::vector<std::pair<Storage, std::string>> back{};
+    result = deserialize(v2, back);
+    ASSERT(result);
+    ASSERT(result.bytes == v2.size());
+    ASSERT(back == storage);
+
+    back.clear();
+    ASSERT(deserialize(v2, back, DeserializeOptions{ .fused_checksum = true }));
+    ASSERT(back == storage);
+
+    // fused校验和、流式输出的结果相同
+    std::vector<uint8_t> fused{};
+    ASSERT(serialize(fused, storage, SerializeOptions{ .fused_checksum = true, .header_version = HeaderVersion::V2 }));
+    ASSERT(fused == v2);
+
+    {
+        FILE* file = std::tmpfile();
+        ASSERT(file != nullptr);
+        {
+            FileSink sink(file, 256);
+            ASSERT(serialize(sink, storage, SerializeOptions{ .header_version = HeaderVersion::V2 }));
+        }
+        const auto content = read_whole_file(file);
+        std::fclose(file);
+        ASSERT(content == v2);
+    }
+
+    // compact_length记录在flags中，读取时不需要额外的选项
+    std::vector<uint8_t> compact{};
+    ASSERT(serialize(compact, storage, SerializeOptions{ .compact_length = true }));
+    ASSERT(memcmp(compact.data(), detail::MagicValueV2, detail::MagicSize) == 0);
+    memcpy(&header, compact.data(), sizeof(header));
+    ASSERT(header.flags == detail::FlagCompactLength);
+    back.clear();
+    ASSERT(deserialize(compact, back));
+    ASSERT(back == storage);
+
+    // 不认识的flags
+    {
+        auto bytes = v2;
+        bytes[detail::FlagsOffsetV2 + 3] = 0x80;
+        ASSERT(deserialize(bytes, back).code == ResultCode::UnsupportedHeader);
+    }
+
+    // reserved不为0
+    {
+        auto bytes = v2;
+        bytes[detail::DataOffsetV2 - 1] = 1;
+        ASSERT(deserialize(bytes, back).code == ResultCode::UnsupportedHeader);
+    }
+
+    // data_length超出容器
+    {
+        auto bytes = v2;
+        bytes[detail::DataLengthOffsetV2 + 7] = 0x01;
+        ASSERT(deserialize(bytes, back).code == ResultCode::ByteContainerTooSmall);
+    }
+
+    // 校验和
+    {
+        auto bytes = v2;
+        bytes.back() ^= 0x01;
+        ASSERT(deserialize(bytes, back).code == ResultCode::ChecksumIncorrect);
+    }
+}
+
+// 修改了数据之后重新计算header中的校验和，用来构造校验和正确、内容损坏的数据
+void reseal_checksum(std::vector<uint8_t>& bytes)
+{
+    using namespace infra::binary_serialization;
+
+    const detail::HeaderLayout& layout = memcmp(bytes.data(), detail::MagicValueV2, detail::MagicSize) == 0
+        ? detail::HeaderV2Layout
+        : detail::HeaderV1Layout;
+
+    crc32c_t crc = update_crc32c_checksum(Initial_CRC32C, bytes.data(), layout.prefix_size);
+    crc = update_crc32c_checksum(crc, bytes.data() + layout.data_offset, bytes.size() - layout.data_offset);
+    crc = update_crc32c_checksum(crc, bytes.data() + layout.data_length_offset, layout.data_length_size);
+    memcpy(bytes.data() + layout.data_length_offset + layout.data_length_size, &crc, sizeof(crc));
+}
+
+void compression_test()
+{
+    using namespace infra::binary_serialization;
+
+    // LZ4 block: 各种长度的可压缩、不可压缩数据
+    std::mt19937 rng(21);
+    for (size_t size : { 0, 1, 5, 12, 13, 14, 15, 16, 19, 20, 64, 255, 270, 1000, 65536 + 100, 300000 })
+    {
+        std::vector<uint8_t> random(size);
+        for (auto& b : random)
+        {
+            b = static_cast<uint8_t>(rng());
+        }
+
+        std::vector<uint8_t> text(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            text[i] = static_cast<uint8_t>("abcabcabdabcx"[(i * 7 / 5) % 13]);
+        }
+
+        std::vector<uint8_t> zeros(size, 0);
+
+        for (const auto* src : { &random, &text, &zeros })
+        {
+            std::vector<uint8_t> packed(detail::lz4_compress_bound(size));
+            const size_t packed_size = detail::lz4_compress(src->data(), size, packed.data(), packed.size());
+            ASSERT(packed_size != 0);
+            ASSERT(packed_size <= packed.size());
+
+            std::vector<uint8_t> back(size);
+            ASSERT(detail::lz4_decompress(packed.data(), packed_size, back.data(), back.size()));
+            ASSERT(back == *src);
+
+            // 输出长度必须完全一致
+            std::vector<uint8_t> longer(size + 1);
+            ASSERT(!detail::lz4_decompress(packed.data(), packed_size, longer.data(), longer.size()));
+            if (size != 0)
+            {
+                ASSERT(!detail::lz4_decompress(packed.data(), packed_size, back.data(), back.size() - 1));
+                ASSERT(!detail::lz4_decompress(packed.data(), packed_size - 1, back.data(), back.size()));
+            }
+        }
+
+        // 长的重复数据至少能压缩到1/50
+        if (size >= 1000)
+        {
+            std::vector<uint8_t> packed(detail::lz4_compress_bound(size));
+            ASSERT(detail::lz4_compress(zeros.data(), size, packed.data(), packed.size()) < size / 50);
+        }
+    }
+
+    // 容量不足时失败，而不是越界
+    {
+        std::vector<uint8_t> random(1000);
+        for (auto& b : random)
+        {
+            b = static_cast<uint8_t>(rng());
+        }
+        std::vector<uint8_t> packed(500);
+        ASSERT(detail::lz4_compress(random.data(), random.size(), packed.data(), packed.size()) == 0);
+    }
+
+    const auto storage = make_records(1000, 23, 'z');
+
+    std::vector<uint8_t> plain{};
+    ASSERT(serialize(plain, storage));
+
+    const SerializeOptions options{ .compression = Compression::Lz4 };
+    std::vector<uint8_t> compressed{};
+    auto result = serialize(compressed, storage, options);
+    ASSERT(result);
+    ASSERT(result.bytes == compressed.size());
+    ASSERT(compressed.size() < plain.size() / 2);
+
+    size_t size = 0;
+    ASSERT(serialized_size(storage, size, options));
+    ASSERT(size == compressed.size());
+
+    // 压缩方式记录在flags中，读取时不需要额外的选项
+    detail::HeaderV2 header{};
+    memcpy(&header, compressed.data(), sizeof(header));
+    ASSERT(memcmp(compressed.data(), detail::MagicValueV2, detail::MagicSize) == 0);
+    ASSERT((header.flags & detail::FlagCompressionMask) == static_cast<uint32_t>(Compression::Lz4));
+    ASSERT(header.data_length == compressed.size() - detail::DataOffsetV2);
+
+    std::vector<std::pair<Storage, std::string>> back{};
+    result = deserialize(compressed, back);
+    ASSERT(result);
+    ASSERT(result.bytes == compressed.size());
+    ASSERT(back == storage);
+
+    back.clear();
+    ASSERT(deserialize(compressed, back, DeserializeOptions{ .fused_checksum = true }));
+    ASSERT(back == storage);
+
+    // 和compact_length、exact_size组合
+    {
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, storage, SerializeOptions{ .exact_size = true, .compact_length = true, .compression = Compression::Lz4 }));
+        memcpy(&header, bytes.data(), sizeof(header));
+        ASSERT(header.flags == (detail::FlagCompactLength | static_cast<uint32_t>(Compression::Lz4)));
+        back.clear();
+        ASSERT(deserialize(bytes, back));
+        ASSERT(back == storage);
+    }
+
+    // 流式输出
+    {
+        FILE* file = std::tmpfile();
+        ASSERT(file != nullptr);
+        {
+            FileSink sink(file, 256);
+            ASSERT(serialize(sink, storage, options));
+        }
+        const auto content = read_whole_file(file);
+        std::fclose(file);
+        ASSERT(content == compressed);
+    }
+
+    // 空对象
+    {
+        std::vector<uint32_t> empty{};
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, empty, options));
+        std::vector<uint32_t> empty_back{ 1, 2 };
+        ASSERT(deserialize(bytes, empty_back));
+        ASSERT(empty_back.empty());
+    }
+
+    // 校验和覆盖压缩后的字节
+    {
+        auto bytes = compressed;
+        bytes[detail::DataOffsetV2 + 20] ^= 0x01;
+        ASSERT(deserialize(bytes, back).code == ResultCode::ChecksumIncorrect);
+    }
+
+    // 校验和正确但压缩数据损坏(原始字节数被篡改)
+    {
+        std::vector<uint32_t> values(100, 7);
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, values, options));
+
+        bytes[detail::DataOffsetV2] ^= 0x01;
+        reseal_checksum(bytes);
+
+        std::vector<uint32_t> values_back{};
+        ASSERT(deserialize(bytes, values_back).code == ResultCode::DecompressionFailed);
+    }
+
+    // 不认识的压缩算法
+    {
+        auto bytes = compressed;
+        bytes[detail::FlagsOffsetV2] = 0x02;
+        ASSERT(deserialize(bytes, back).code == ResultCode::UnsupportedHeader);
+    }
+
+    // 零拷贝视图不能指向解压用的临时缓冲区
+    {
+        std::vector<std::string_view> names{ "alpha", "beta", "gamma" };
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, names, options));
+
+        std::vector<std::string_view> views{};
+        ASSERT(deserialize(bytes, views).code == ResultCode::DecompressionFailed);
+
+        std::vector<std::string> strings{};
+        ASSERT(deserialize(bytes, strings));
+        ASSERT(strings.size() == 3 && strings[1] == "beta");
+    }
+}
+
+void chunked_test()
+{
+    using namespace infra::binary_serialization;
+
+    const auto storage = make_records(1000, 23, 'c');
+
+    std::vector<uint8_t> v2{};
+    ASSERT(serialize(v2, storage, SerializeOptions{ .header_version = HeaderVersion::V2 }));
+    const size_t payload_size = v2.size() - detail::DataOffsetV2;
+
+    const SerializeOptions options{ .chunk_size = 1024 };
+    std::vector<uint8_t> chunked{};
+    auto result = serialize(chunked, storage, options);
+    ASSERT(result);
+    ASSERT(result.bytes == chunked.size());
+
+    // 数据区开头是分块表，之后的数据不变
+    const size_t chunk_count = (payload_size + 1023) / 1024;
+    const size_t table_size = chunk_count * detail::ChunkEntrySize + detail::ChunkCountSize;
+    const size_t payload_offset = detail::DataOffsetV2 + table_size;
+    ASSERT(chunked.size() == v2.size() + table_size);
+    ASSERT(std::equal(v2.begin() + detail::DataOffsetV2, v2.end(), chunked.begin() + payload_offset));
+
+    detail::HeaderV2 header{};
+    memcpy(&header, chunked.data(), sizeof(header));
+    ASSERT(header.flags == detail::FlagChunked);
+    ASSERT(header.data_length == chunked.size() - detail::DataOffsetV2);
+
+    uint64_t stored_count = 0;
+    memcpy(&stored_count, chunked.data() + detail::DataOffsetV2, sizeof(stored_count));
+    ASSERT(stored_count == chunk_count);
+
+    for (size_t i = 0; i < chunk_count; ++i)
+    {
+        const uint8_t* entry = chunked.data() + detail::DataOffsetV2 + detail::ChunkCountSize + i * detail::ChunkEntrySize;
+        uint32_t length = 0;
+        crc32c_t crc = 0;
+        memcpy(&length, entry, sizeof(length));
+        memcpy(&crc, entry + sizeof(length), sizeof(crc));
+        ASSERT(length == std::min<size_t>(1024, payload_size - i * 1024));
+        ASSERT(crc == update_crc32c_checksum(Initial_CRC32C, chunked.data() + payload_offset + i * 1024, length));
+    }
+
+    size_t size = 0;
+    ASSERT(serialized_size(storage, size, options));
+    ASSERT(size == chunked.size());
+
+    std::vector<std::pair<Storage, std::string>> back{};
+    result = deserialize(chunked, back);
+    ASSERT(result);
+    ASSERT(result.bytes == chunked.size());
+    ASSERT(back == storage);
+
+    std::vector<size_t> corrupt{ 100 };
+    result = verify_chunks(chunked, corrupt);
+    ASSERT(result);
+    ASSERT(result.bytes == chunked.size());
+    ASSERT(corrupt.empty());
+
+    // fused校验和、exact_size、流式输出的结果相同
+    {
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, storage, SerializeOptions{ .exact_size = true, .fused_checksum = true, .chunk_size = 1024 }));
+        ASSERT(bytes == chunked);
+    }
+    {
+        FILE* file = std::tmpfile();
+        ASSERT(file != nullptr);
+        {
+            FileSink sink(file, 100);
+            ASSERT(serialize(sink, storage, options));
+        }
+        const auto content = read_whole_file(file);
+        std::fclose(file);
+        ASSERT(content == chunked);
+    }
+
+    // 定位损坏的块
+    {
+        auto bytes = chunked;
+        bytes[payload_offset + 3 * 1024 + 5] ^= 0x01;
+        bytes[payload_offset + 7 * 1024] ^= 0x80;
+        ASSERT(deserialize(bytes, back).code == ResultCode::ChecksumIncorrect);
+        ASSERT(deserialize(bytes, back, DeserializeOptions{ .fused_checksum = true }).code == ResultCode::ChecksumIncorrect);
+        ASSERT(verify_chunks(bytes, corrupt, 4).code == ResultCode::ChecksumIncorrect);
+        ASSERT((corrupt == std::vector<size_t>{ 3, 7 }));
+    }
+
+    // 分块表损坏时无法定位
+    {
+        auto bytes = chunked;
+        bytes[detail::DataOffsetV2 + detail::ChunkCountSize + 1] ^= 0x01;
+        ASSERT(deserialize(bytes, back).code == ResultCode::ChecksumIncorrect);
+        ASSERT(verify_chunks(bytes, corrupt).code == ResultCode::ChecksumIncorrect);
+        ASSERT(corrupt.empty());
+
+        bytes = chunked;
+        bytes[detail::DataOffsetV2 + 6] = 0x10;
+        ASSERT(deserialize(bytes, back).code == ResultCode::ChecksumIncorrect);
+    }
+
+    // 分块表与数据区不一致(校验和正确)
+    {
+        auto bytes = chunked;
+        uint8_t* table = bytes.data() + detail::DataOffsetV2;
+        table[detail::ChunkCountSize] ^= 0x01;
+        const crc32c_t crc = update_crc32c_checksum(
+            update_crc32c_checksum(
+                update_crc32c_checksum(Initial_CRC32C, bytes.data(), detail::DataLengthOffsetV2),
+                table, table_size),
+            bytes.data() + detail::DataLengthOffsetV2, detail::DataLengthSizeV2);
+        memcpy(bytes.data() + detail::ChecksumOffsetV2, &crc, sizeof(crc));
+        ASSERT(deserialize(bytes, back).code == ResultCode::InvalidChunkTable);
+    }
+
+    // 不是分块存储
+    ASSERT(verify_chunks(v2, corrupt).code == ResultCode::UnsupportedHeader);
+
+    // 和压缩组合: 按压缩后的字节分块
+    {
+        const SerializeOptions lz4_options{ .compression = Compression::Lz4, .chunk_size = 256 };
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, storage, lz4_options));
+        memcpy(&header, bytes.data(), sizeof(header));
+        ASSERT(header.flags == (detail::FlagChunked | static_cast<uint32_t>(Compression::Lz4)));
+        ASSERT(serialized_size(storage, size, lz4_options));
+        ASSERT(size == bytes.size());
+
+        back.clear();
+        ASSERT(deserialize(bytes, back));
+        ASSERT(back == storage);
+        ASSERT(verify_chunks(bytes, corrupt));
+
+        uint64_t lz4_chunks = 0;
+        memcpy(&lz4_chunks, bytes.data() + detail::DataOffsetV2, sizeof(lz4_chunks));
+        bytes[detail::DataOffsetV2 + detail::ChunkCountSize + lz4_chunks * detail::ChunkEntrySize + 300] ^= 0x01;
+        ASSERT(deserialize(bytes, back).code == ResultCode::ChecksumIncorrect);
+        ASSERT(verify_chunks(bytes, corrupt).code == ResultCode::ChecksumIncorrect);
+        ASSERT((corrupt == std::vector<size_t>{ 1 }));
+    }
+
+    // 空对象
+    {
+        std::vector<uint32_t> empty{};
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, empty, options));
+        std::vector<uint32_t> empty_back{ 1 };
+        ASSERT(deserialize(bytes, empty_back));
+        ASSERT(empty_back.empty());
+    }
+
+    // 零拷贝视图直接指向分块的数据
+    {
+        std::vector<std::string_view> names{ "alpha", "beta", "gamma" };
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, names, SerializeOptions{ .chunk_size = 7 }));
+        std::vector<std::string_view> views{};
+        ASSERT(deserialize(bytes, views));
+        ASSERT(views == names);
+        ASSERT(views[2].data() > std::bit_cast<const char*>(bytes.data()));
+    }
+
+    // 大数据多线程校验
+    {
+        std::vector<uint8_t> big(ParallelChecksumThreshold + 17);
+        for (size_t i = 0; i < big.size(); ++i)
+        {
+            big[i] = static_cast<uint8_t>(i * 131 + (i >> 12));
+        }
+
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, big, SerializeOptions{ .chunk_size = 64 * 1024 }));
+        ASSERT(verify_chunks(bytes, corrupt, 8));
+
+        const size_t big_offset = bytes.size() - big.size();
+        bytes[big_offset + 20 * 1024 * 1024] ^= 0x01;
+        ASSERT(verify_chunks(bytes, corrupt, 8).code == ResultCode::ChecksumIncorrect);
+        ASSERT((corrupt == std::vector<size_t>{ 20 * 1024 / 64 }));
+
+        std::vector<uint8_t> big_back{};
+        ASSERT(deserialize(bytes, big_back).code == ResultCode::ChecksumIncorrect);
+        bytes[big_offset + 20 * 1024 * 1024] ^= 0x01;
+        ASSERT(deserialize(bytes, big_back));
+        ASSERT(big_back == big);
+    }
+}
+
+// 写入时是names，读取时是table; 没有特化holds_buffer_view，可以从压缩的数据中读取
+struct Storage_IndexedField
+{
+    std::vector<std::string> names;
+    infra::binary_serialization::IndexedTable<std::string> table;
+};
+
+namespace infra::binary_serialization
+{
+    template<typename ByteContainer>
+    void from_bytes(
+        Reader<ByteContainer>& reader,
+        Storage_IndexedField& storage
+    )
+    {
+        reader >> storage.table;
+    }
+
+    template<typename ByteContainer>
+    void to_bytes(
+        Writer<ByteContainer>& writer,
+        const Storage_IndexedField& storage
+    )
+    {
+        writer << IndexedVector{ storage.names };
+    }
+}
+
+void indexed_table_test()
+{
+    using namespace infra::binary_serialization;
+
+    const auto records = make_records(500, 37);
+
+    for (const bool compact : { false, true })
+    {
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, IndexedVector{ records }, SerializeOptions{ .compact_length = compact }));
+
+        // 计数时不统计每个元素的字节数，结果相同
+        size_t size = 0;
+        ASSERT(serialized_size(IndexedVector{ records }, size, SerializeOptions{ .compact_length = compact }));
+        ASSERT(size == bytes.size());
+
+        IndexedTable<std::pair<Storage, std::string>> table{};
+        auto result = deserialize(bytes, table);
+        ASSERT(result);
+        ASSERT(result.bytes == bytes.size());
+        ASSERT(table.size() == records.size());
+
+        // 任意下标直接解码
+        for (size_t i : { 0, 1, 250, 498, 499, 37, 36 })
+        {
+            std::pair<Storage, std::string> record{};
+            ASSERT(table.get(i, record) == ResultCode::OK);
+            ASSERT(record == records[i]);
+        }
+
+        std::pair<Storage, std::string> record{};
+        ASSERT(table.get(500, record) == ResultCode::InvalidIndex);
+
+        std::vector<std::pair<Storage, std::string>> range{};
+        ASSERT(table.get_range(100, 50, range) == ResultCode::OK);
+        ASSERT(std::equal(range.begin(), range.end(), records.begin() + 100, records.begin() + 150));
+        ASSERT(table.get_range(490, 11, range) == ResultCode::InvalidIndex);
+        ASSERT(range.size() == 50);
+        ASSERT(table.get_range(500, 0, range) == ResultCode::OK);
+
+        ASSERT(table.bytes(3).size() == sizeof(Storage) + (compact ? 1 : sizeof(uint64_t)) + 3);
+        ASSERT(table.bytes(500).empty());
+    }
+
+    // 定长元素不需要统计每个元素的字节数
+    {
+        std::vector<uint32_t> numbers(1000);
+        for (uint32_t i = 0; i < numbers.size(); ++i)
+        {
+            numbers[i] = i * 2654435761u;
+        }
+
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, IndexedVector{ numbers }));
+        ASSERT(bytes.size() == detail::DataOffset + sizeof(uint64_t) * (numbers.size() + 2) + numbers.size() * sizeof(uint32_t));
+
+        IndexedTable<uint32_t> table{};
+        ASSERT(deserialize(bytes, table));
+        uint32_t n = 0;
+        ASSERT(table.get(777, n) == ResultCode::OK && n == numbers[777]);
+    }
+
+    // 空表
+    {
+        std::vector<std::string> empty{};
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, IndexedVector{ empty }));
+        IndexedTable<std::string> table{};
+        ASSERT(deserialize(bytes, table));
+        ASSERT(table.empty());
+    }
+
+    // 索引中的偏移损坏(校验和正确)
+    {
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, IndexedVector{ records }));
+
+        // 第10个元素的起始偏移(也是第9个元素的结束偏移)超出了元素数据的范围
+        bytes[detail::DataOffset + sizeof(uint64_t) * 11 + 2] = 0x7f;
+        reseal_checksum(bytes);
+
+        IndexedTable<std::pair<Storage, std::string>> table{};
+        ASSERT(deserialize(bytes, table));
+
+        std::pair<Storage, std::string> record{};
+        ASSERT(table.get(9, record) == ResultCode::InvalidIndex);
+        ASSERT(table.get(10, record) == ResultCode::InvalidIndex);
+        ASSERT(table.get(11, record) == ResultCode::OK);
+        ASSERT(record == records[11]);
+    }
+
+    // 压缩的数据解压到临时缓冲区: 表复制索引和元素数据，deserialize返回后仍然可以访问
+    {
+        Storage_IndexedField field{};
+        field.names = { "alpha", "beta", "gamma" };
+
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, field, SerializeOptions{ .compression = Compression::Lz4 }));
+
+        Storage_IndexedField back{};
+        ASSERT(deserialize(bytes, back));
+        const Storage_IndexedField copied = back;
+        ASSERT(back.table.size() == 3);
+
+        std::string name{};
+        ASSERT(back.table.get(2, name) == ResultCode::OK && name == "gamma");
+        ASSERT(copied.table.get(0, name) == ResultCode::OK && name == "alpha");
+        ASSERT(copied.table.bytes(1).size() == sizeof(uint64_t) + 4);
+    }
+}
+
+struct Storage_Lazy
+{
+    uint32_t id = 0;
+    infra::binary_serialization::Lazy<std::map<std::u8string, Storage>> attributes;
+    infra::binary_serialization::Lazy<std::string> note;
+    infra::binary_serialization::Lazy<Storage> fixed;
+    uint64_t tail = 0;
+};
+
+namespace infra::binary_serialization
+{
+    template<>
+    struct holds_buffer_view<Storage_Lazy> : std::true_type {};
+
+    template<typename ByteContainer>
+    void from_bytes(
+        Reader<ByteContainer>& reader,
+        Storage_Lazy& storage
+    )
+    {
+        reader >> storage.id;
+        reader >> storage.attributes;
+        reader >> storage.note;
+        reader >> storage.fixed;
+        reader >> storage.tail;
+    }
+
+    template<typename ByteContainer>
+    void to_bytes(
+        Writer<ByteContainer>& writer,
+        const Storage_Lazy& storage
+    )
+    {
+        writer << storage.id;
+        writer << storage.attributes;
+        writer << storage.note;
+        writer << storage.fixed;
+        writer << storage.tail;
+    }
+}
+
+// 没有特化holds_buffer_view，可以从压缩的数据中读取
+struct Storage_LazyField
+{
+    uint32_t id = 0;
+    infra::binary_serialization::Lazy<std::string> note;
+};
+
+namespace infra::binary_serialization
+{
+    template<typename ByteContainer>
+    void from_bytes(
+        Reader<ByteContainer>& reader,
+        Storage_LazyField& storage
+    )
+    {
+        reader >> storage.id;
+        reader >> storage.note;
+    }
+
+    template<typename ByteContainer>
+    void to_bytes(
+        Writer<ByteContainer>& writer,
+        const Storage_LazyField& storage
+    )
+    {
+        writer << storage.id;
+        writer << storage.note;
+    }
+}
+
+void lazy_test()
+{
+    using namespace infra::binary_serialization;
+
+    Storage_Lazy storage{};
+    storage.id = 42;
+    storage.attributes.set({
+        { u8"first",  Storage{ 1, 2, 3 } },
+        { u8"second", Storage{ 4, 5, 6 } },
+    });
+    storage.note.set(std::string(100, 'n'));
+    storage.fixed.set(Storage{ 7, 8, 9 });
+    storage.tail = 0x1122334455667788ULL;
+
+    for (const bool compact : { false, true })
+    {
+        const SerializeOptions options{ .compact_length = compact };
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, storage, options));
+
+        size_t size = 0;
+        ASSERT(serialized_size(storage, size, options));
+        ASSERT(size == bytes.size());
+
+        // 读取时只记录字节范围，之后的字段照常读取
+        Storage_Lazy back{};
+        ASSERT(deserialize(bytes, back));
+        ASSERT(back.id == 42);
+        ASSERT(back.tail == storage.tail);
+        ASSERT(!back.attributes.decoded());
+        ASSERT(!back.note.decoded());
+
+        // 没有访问过的字段原样写回
+        std::vector<uint8_t> again{};
+        ASSERT(serialize(again, back, options));
+        ASSERT(again == bytes);
+
+        // 第一次访问时解码
+        const auto* attributes = back.attributes.get();
+        ASSERT(attributes != nullptr);
+        ASSERT(back.attributes.decoded());
+        ASSERT(*attributes == *storage.attributes.get());
+        ASSERT((back.fixed.get() != nullptr && *back.fixed.get() == Storage{ 7, 8, 9 }));
+
+        // 修改之后写入新的值
+        back.note.get()->append("!");
+        again.clear();
+        ASSERT(serialize(again, back, options));
+        Storage_Lazy modified{};
+        ASSERT(deserialize(again, modified));
+        ASSERT(*modified.note.get() == std::string(100, 'n') + "!");
+        ASSERT(*modified.attributes.get() == *storage.attributes.get());
+
+        // 以不同的编码方式写出: 先解码再重新编码
+        const SerializeOptions other{ .compact_length = !compact };
+        Storage_Lazy untouched{};
+        ASSERT(deserialize(bytes, untouched));
+        std::vector<uint8_t> converted{};
+        ASSERT(serialize(converted, untouched, other));
+        std::vector<uint8_t> expected{};
+        ASSERT(serialize(expected, storage, other));
+        ASSERT(converted == expected);
+    }
+
+    // 延迟字段损坏: 读取成功，访问时失败
+    {
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, storage));
+
+        // note: Lazy的长度前缀 + std::string的长度前缀 + 100个'n'
+        const std::string note(100, 'n');
+        const auto note_text = std::search(bytes.begin(), bytes.end(), note.begin(), note.end());
+        ASSERT(note_text != bytes.end());
+        const size_t note_offset = static_cast<size_t>(note_text - bytes.begin()) - 2 * sizeof(uint64_t);
+        uint64_t note_size = 0;
+        memcpy(&note_size, bytes.data() + note_offset, sizeof(note_size));
+        ASSERT(note_size == sizeof(uint64_t) + 100);
+
+        bytes[note_offset + sizeof(uint64_t)] = 0xff;
+        reseal_checksum(bytes);
+
+        Storage_Lazy back{};
+        ASSERT(deserialize(bytes, back));
+        ASSERT(back.tail == storage.tail);
+        ASSERT(back.note.get() == nullptr);
+        ASSERT(back.note.result() == ResultCode::LengthExceedsData);
+        ASSERT(back.attributes.get() != nullptr);
+
+        std::vector<uint8_t> again{};
+        ASSERT(serialize(again, back).code == ResultCode::UserAbort);
+    }
+
+    // 引用源缓冲区，不能从临时容器读取
+    static_assert(!can_deserialize_from<std::vector<uint8_t>, Storage_Lazy>);
+    static_assert(can_deserialize_from<std::vector<uint8_t>&, Storage_Lazy>);
+
+    // 嵌套的延迟字段: 计数时不需要先统计内层的字节数
+    for (const bool compact : { false, true })
+    {
+        const SerializeOptions options{ .compact_length = compact };
+        const Lazy<Lazy<std::string>> nested{ Lazy<std::string>{ std::string(50, 'q') } };
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, nested, options));
+        size_t size = 0;
+        ASSERT(serialized_size(nested, size, options));
+        ASSERT(size == bytes.size());
+    }
+
+    // 压缩的数据解压到临时缓冲区: 延迟字段复制自己的编码，deserialize返回后仍然可以访问
+    {
+        Storage_LazyField field{};
+        field.id = 7;
+        field.note.set(std::string(300, 'z'));
+
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, field, SerializeOptions{ .compression = Compression::Lz4 }));
+
+        Storage_LazyField back{};
+        ASSERT(deserialize(bytes, back));
+        ASSERT(back.id == 7);
+        ASSERT(!back.note.decoded());
+
+        Storage_LazyField copied = back;
+        ASSERT(back.note.get() != nullptr && *back.note.get() == std::string(300, 'z'));
+        ASSERT(copied.note.get() != nullptr && *copied.note.get() == std::string(300, 'z'));
+
+        std::vector<uint8_t> plain{};
+        ASSERT(serialize(plain, Storage_LazyField{ 7, std::string(300, 'z') }));
+        Storage_LazyField untouched{};
+        ASSERT(deserialize(bytes, untouched));
+        std::vector<uint8_t> again{};
+        ASSERT(serialize(again, untouched));
+        ASSERT(again == plain);
+    }
+}
+
+// 同一个结构体的两个版本，V2在末尾增加了字段
+struct Storage_FramedV1
+{
+    uint32_t id = 0;
+    std::string name;
+};
+
+struct Storage_FramedV2
+{
+    uint32_t id = 0;
+    std::string name;
+    std::vector<uint64_t> tags;
+    uint16_t flags = 0;
+};
+
+struct Storage_FramedFixed
+{
+    uint64_t a = 0;
+    uint32_t b = 0;
+};
+
+struct Storage_FramedOuter
+{
+    Storage_FramedV2 record;
+    Storage_FramedFixed fixed[2];
+    uint32_t tail = 0;
+};
+
+namespace infra::binary_serialization
+{
+    template<> struct enable_framed_serialization<Storage_FramedV1> : std::true_type {};
+    template<> struct enable_framed_serialization<Storage_FramedV2> : std::true_type {};
+    template<> struct enable_framed_serialization<Storage_FramedFixed> : std::true_type {};
+    template<> struct fixed_serialized_size<Storage_FramedFixed> : fixed_serialized_size_sum<uint64_t, uint32_t> {};
+
+    template<typename ByteContainer>
+    void to_bytes(Writer<ByteContainer>& writer, const Storage_FramedV1& storage)
+    {
+        writer << storage.id;
+        writer << storage.name;
+    }
+
+    template<typename ByteContainer>
+    void from_bytes(Reader<ByteContainer>& reader, Storage_FramedV1& storage)
+    {
+        reader >> storage.id;
+        reader >> storage.name;
+    }
+
+    template<typename ByteContainer>
+    void to_bytes(Writer<ByteContainer>& writer, const Storage_FramedV2& storage)
+    {
+        writer << storage.id;
+        writer << storage.name;
+        writer << storage.tags;
+        writer << storage.flags;
+    }
+
+    template<typename ByteContainer>
+    void from_bytes(Reader<ByteContainer>& reader, Storage_FramedV2& storage)
+    {
+        reader >> storage.id;
+        reader >> storage.name;
+
+        // 旧版本的数据没有新增的字段
+        if (reader.remaining() == 0)
+            return;
+
+        reader >> storage.tags;
+        reader >> storage.flags;
+    }
+
+    template<typename ByteContainer>
+    void to_bytes(Writer<ByteContainer>& writer, const Storage_FramedFixed& storage)
+    {
+        writer << storage.a;
+        writer << storage.b;
+    }
+
+    template<typename ByteContainer>
+    void from_bytes(Reader<ByteContainer>& reader, Storage_FramedFixed& storage)
+    {
+        reader >> storage.a;
+        reader >> storage.b;
+    }
+
+    template<typename ByteContainer>
+    void to_bytes(Writer<ByteContainer>& writer, const Storage_FramedOuter& storage)
+    {
+        writer << storage.record;
+        writer << storage.fixed;
+        writer << storage.tail;
+    }
+
+    template<typename ByteContainer>
+    void from_bytes(Reader<ByteContainer>& reader, Storage_FramedOuter& storage)
+    {
+        reader >> storage.record;
+        reader >> storage.fixed;
+        reader >> storage.tail;
+    }
+}
+
+// 与Storage_FramedV1/V2相同的两个版本，但不是framed结构体，只能作为顶层对象按remaining判断新增的字段
+struct Storage_TopLevelV1
+{
+    uint32_t id = 0;
+    std::string name;
+};
+
+struct Storage_TopLevelV2
+{
+    uint32_t id = 0;
+    std::string name;
+    uint16_t flags = 0;
+};
+
+namespace infra::binary_serialization
+{
+    template<typename ByteContainer>
+    void to_bytes(Writer<ByteContainer>& writer, const Storage_TopLevelV1& storage)
+    {
+        writer << storage.id;
+        writer << storage.name;
+    }
+
+    template<typename ByteContainer>
+    void from_bytes(Reader<ByteContainer>& reader, Storage_TopLevelV2& storage)
+    {
+        reader >> storage.id;
+        reader >> storage.name;
+
+        if (reader.remaining() == 0)
+            return;
+
+        reader >> storage.flags;
+    }
+}
+
+void framed_structure_test()
+{
+    using namespace infra::binary_serialization;
+
+    static_assert(fixed_serialized_size_v<Storage_FramedFixed> == 0);
+    static_assert(!is_bulk_serializable<Storage_FramedFixed>);
+
+    std::vector<Storage_FramedV2> v2{};
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        v2.push_back(Storage_FramedV2{ i, std::string(i % 13, 'f'), std::vector<uint64_t>(i % 5, i), static_cast<uint16_t>(i * 3) });
+    }
+
+    for (const bool compact : { false, true })
+    {
+        const SerializeOptions options{ .compact_length = compact };
+
+        // 新版本写入，新版本读取
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, std::make_pair(v2, uint32_t{ 0xCAFE }), options));
+
+        size_t size = 0;
+        ASSERT(serialized_size(std::make_pair(v2, uint32_t{ 0xCAFE }), size, options));
+        ASSERT(size == bytes.size());
+
+        std::pair<std::vector<Storage_FramedV2>, uint32_t> back_v2{};
+        ASSERT(deserialize(bytes, back_v2));
+        ASSERT(back_v2.second == 0xCAFE);
+        ASSERT(back_v2.first.size() == v2.size());
+        for (size_t i = 0; i < v2.size(); ++i)
+        {
+            ASSERT(back_v2.first[i].id == v2[i].id);
+            ASSERT(back_v2.first[i].tags == v2[i].tags);
+            ASSERT(back_v2.first[i].flags == v2[i].flags);
+        }
+
+        // 旧版本读取新版本的数据: 跳过不认识的字段
+        std::pair<std::vector<Storage_FramedV1>, uint32_t> back_v1{};
+        ASSERT(deserialize(bytes, back_v1));
+        ASSERT(back_v1.second == 0xCAFE);
+        ASSERT(back_v1.first.size() == v2.size());
+        for (size_t i = 0; i < v2.size(); ++i)
+        {
+            ASSERT(back_v1.first[i].id == v2[i].id);
+            ASSERT(back_v1.first[i].name == v2[i].name);
+        }
+
+        // 新版本读取旧版本的数据: 新增的字段保持默认值
+        std::vector<uint8_t> old_bytes{};
+        ASSERT(serialize(old_bytes, std::make_pair(back_v1.first, uint32_t{ 0xBEEF }), options));
+        back_v2 = {};
+        ASSERT(deserialize(old_bytes, back_v2));
+        ASSERT(back_v2.second == 0xBEEF);
+        ASSERT(back_v2.first[7].name == v2[7].name);
+        ASSERT(back_v2.first[7].tags.empty());
+        ASSERT(back_v2.first[7].flags == 0);
+    }
+
+    // 嵌套、C数组、声明了定长的结构体
+    {
+        Storage_FramedOuter outer{};
+        outer.record = Storage_FramedV2{ 1, "outer", { 1, 2, 3 }, 4 };
+        outer.fixed[0] = Storage_FramedFixed{ 5, 6 };
+        outer.fixed[1] = Storage_FramedFixed{ 7, 8 };
+        outer.tail = 9;
+
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, outer, SerializeOptions{ .exact_size = true }));
+
+        // 定长结构体: 长度前缀 + 12B
+        uint64_t fixed_size = 0;
+        memcpy(&fixed_size, bytes.data() + bytes.size() - sizeof(uint32_t) - 2 * (sizeof(uint64_t) + 12), sizeof(fixed_size));
+        ASSERT(fixed_size == 12);
+
+        Storage_FramedOuter back{};
+        ASSERT(deserialize(bytes, back));
+        ASSERT(back.record.name == "outer");
+        ASSERT(back.record.tags == outer.record.tags);
+        ASSERT(back.fixed[1].a == 7 && back.fixed[1].b == 8);
+        ASSERT(back.tail == 9);
+    }
+
+    // 长度前缀超出数据 / 结构体的读取越过了自己的字节范围
+    {
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, Storage_FramedV1{ 3, "abc" }));
+
+        auto corrupt = bytes;
+        corrupt[detail::DataOffset + 7] = 0x01;
+        reseal_checksum(corrupt);
+
+        Storage_FramedV1 back{};
+        ASSERT(deserialize(corrupt, back).code == ResultCode::LengthExceedsData);
+
+        // 帧的长度比内容短: name的读取不能越过帧
+        corrupt = bytes;
+        corrupt[detail::DataOffset] -= 1;
+        reseal_checksum(corrupt);
+        ASSERT(deserialize(corrupt, back).code == ResultCode::LengthExceedsData);
+    }
+
+    // 顶层结构体(不是framed)中的remaining只计算数据区，容器中数据区之后的字节不算新增的字段
+    {
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, Storage_TopLevelV1{ 5, "top" }));
+        bytes.resize(bytes.size() + 64, 0xAB);
+
+        Storage_TopLevelV2 back{};
+        ASSERT(deserialize(bytes, back));
+        ASSERT(back.id == 5 && back.name == "top");
+        ASSERT(back.flags == 0);
+    }
+}
+
+// 只需要Storage_FramedOuter::tail，前面的framed结构体都不解码
+struct Storage_FramedTailOnly
+{
+    uint32_t tail = 0;
+};
+
+namespace infra::binary_serialization
+{
+    template<typename ByteContainer>
+    void from_bytes(Reader<ByteContainer>& reader, Storage_FramedTailOnly& storage)
+    {
+        reader.skip_frame();    // record
+        reader.skip_frame();    // fixed[0]
+        reader.skip_frame();    // fixed[1]
+        reader >> storage.tail;
+    }
+}
+
+void skip_frame_test()
+{
+    using namespace infra::binary_serialization;
+
+    Storage_FramedOuter outer{};
+    outer.record = Storage_FramedV2{ 1, std::string(1000, 's'), std::vector<uint64_t>(1000, 7), 4 };
+    outer.tail = 0x12345678;
+
+    for (const bool compact : { false, true })
+    {
+        std::vector<uint8_t> bytes{};
+        ASSERT(serialize(bytes, outer, SerializeOptions{ .compact_length = compact }));
+
+        Storage_FramedTailOnly tail_only{};
+        auto result = deserialize(bytes, tail_only);
+        ASSERT(result);
+        ASSERT(result.bytes == bytes.size());
+        ASSERT(tail_only.tail == outer.tail);
+    }
+}
+
+struct Storage_Bool
+{
+    uint64_t a;
+    bool b1;
+    uint32_t c;
+    bool b2;
+    bool b3[3][2];
+};
+
+namespace infra::binary_serialization
+{
+    template<typename ByteContainer>
+    void from_bytes(
+        Reader<ByteContainer>& reader,
+        Storage_Bool& storage
+    )
+    {
+        reader >> storage.a;
+        reader >> storage.b1;
+        reader >> storage.c;
+        reader >> storage.b2;
+        reader >> storage.b3;
+    }
+
+    template<typename ByteContainer>
+    void to_bytes(
+        Writer<ByteContainer>& writer,
+        const Storage_Bool& storage
+    )
+    {
+        writer << storage.a;
+        writer << storage.b1;
+        writer << storage.c;
+        writer << storage.b2;
+        writer << storage.b3;
+    }
+}
+
+void bool_test()
+{
+    using namespace infra::binary_serialization;
+
+    {
+        Storage_Bool storage{
+            0x0102030405060708ULL,
+            true,
+            0x11223344,
+            false,
+            { {true, false}, {false, true}, {true, true} } // b3
+        };
+
+        std::vector<uint8_t> buffer{};
+        infra::binary_serialization::serialize(buffer, storage);
+
+        // magic
+        ASSERT(buffer[detail::MagicOffset + 0] == detail::MagicValue[0]);
+        ASSERT(buffer[detail::MagicOffset + 1] == detail::MagicValue[1]);
+        ASSERT(buffer[detail::MagicOffset + 2] == detail::MagicValue[2]);
+        ASSERT(buffer[detail::MagicOffset + 3] == detail::MagicValue[3]);
+
+        // checksum
+        crc32c_t checksum = update_crc32c_checksum(Initial_CRC32C, &buffer[detail::MagicOffset], detail::MagicSize);
+        // 数据长度 = 14 原来的 + 6 (b3 3*2 bytes)
+        checksum = update_crc32c_checksum(checksum, &buffer[detail::DataOffset], 14 + 6);
+        checksum = update_crc32c_checksum(checksum, &buffer[detail::DataLengthOffset], detail::DataLengthSize);
+        ASSERT(*reinterpret_cast<crc32c_t*>(&buffer[detail::ChecksumOffset]) == checksum);
+
+        // data length = 20 bytes (0x14)
+        ASSERT(buffer[detail::DataLengthOffset + 0] == 0x14);
+        ASSERT(buffer[detail::DataLengthOffset + 1] == 0x00);
+        ASSERT(buffer[detail::DataLengthOffset + 2] == 0x00);
+        ASSERT(buffer[detail::DataLengthOffset + 3] == 0x00);
+
+        // data (little endian)
+
+        // uint64_t a = 0x0102030405060708
+        ASSERT(buffer[detail::DataOffset + 0] == 0x08);
+        ASSERT(buffer[detail::DataOffset + 1] == 0x07);
+        ASSERT(buffer[detail::DataOffset + 2] == 0x06);
+        ASSERT(buffer[detail::DataOffset + 3] == 0x05);
+        ASSERT(buffer[detail::DataOffset + 4] == 0x04);
+        ASSERT(buffer[detail::DataOffset + 5] == 0x03);
+        ASSERT(buffer[detail::DataOffset + 6] == 0x02);
+        ASSERT(buffer[detail::DataOffset + 7] == 0x01);
+
+        // bool b1 = true
+        ASSERT(buffer[detail::DataOffset + 8] == 0x01);
+
+        // uint32_t c = 0x11223344
+        ASSERT(buffer[detail::DataOffset + 9]  == 0x44);
+        ASSERT(buffer[detail::DataOffset + 10] == 0x33);
+        ASSERT(buffer[detail::DataOffset + 11] == 0x22);
+        ASSERT(buffer[detail::DataOffset + 12] == 0x11);
+
+        // bool b2 = false
+        ASSERT(buffer[detail::DataOffset + 13] == 0x00);
+
+        // bool b3[3][2] = {{1,0},{0,1},{1,1}}
+        ASSERT(buffer[detail::DataOffset + 14] == 0x01);
+        ASSERT(buffer[detail::DataOffset + 15] == 0x00);
+        ASSERT(buffer[detail::DataOffset + 16] == 0x00);
+        ASSERT(buffer[detail::DataOffset + 17] == 0x01);
+        ASSERT(buffer[detail::DataOffset + 18] == 0x01);
+        ASSERT(buffer[detail::DataOffset + 19] == 0x01);
+
+        // sizeof 检查
+        ASSERT(sizeof(Storage_Bool) <= buffer.size());
+
+        // 反序列化测试
+        Storage_Bool back{ 0, false, 0, true, {} };
+        auto result = infra::binary_serialization::deserialize(buffer, back);
+
+        ASSERT(result);
+        ASSERT(result.code == ResultCode::OK);
+
+        ASSERT(back.a  == 0x0102030405060708ULL);
+        ASSERT(back.b1 == true);
+        ASSERT(back.c  == 0x11223344);
+        ASSERT(back.b2 == false);
+
+        ASSERT(back.b3[0][0] == true);
+        ASSERT(back.b3[0][1] == false);
+        ASSERT(back.b3[1][0] == false);
+        ASSERT(back.b3[1][1] == true);
+        ASSERT(back.b3[2][0] == true);
+        ASSERT(back.b3[2][1] == true);
+    }
+}
+
+
+struct Storage_SubFile
+{
+    std::string str;
+    std::map<std::string, std::pair<uint32_t, bool>> map;
+};
+
+namespace infra::binary_serialization
+{
+    template<typename ByteContainer>
+    void from_bytes(
+        Reader<ByteContainer>& reader,
+        Storage_SubFile& storage
+    )
+    {
+        reader >> storage.str;
+        reader >> storage.map;
+    }
+
+    template<typename ByteContainer>
+    void to_bytes(
+        Writer<ByteContainer>& writer,
+        const Storage_SubFile& storage
+    )
+    {
+        writer << storage.str;
+        writer << storage.map;
+    }
+}
+
+struct Storage_File
+{
+    // 1. bool变量 + bool C数组
+    bool flag1;
+    bool flag2;
+    bool arr_bool[2][3];
+
+    // 2. 整型变量及C数组
+    uint32_t u32;
+    int64_t i64;
+    uint16_t u16;
 
     uint32_t arr_u32[2];
     int64_t arr_i64[2][2];
@@ -2029,32 +4455,9 @@ void write_to_file()
     std::cout << "Successfully wrote to: " << file_path << std::endl;
 }
 
-void deserialize_from_file_test()
+void verify_storage_file(const Storage_File& back)
 {
-    // write_to_file();
-
-    namespace fs = std::filesystem;
-    fs::path file_path = fs::path(INFRA_TEST_EXE_DIR) / "test_file.bin";
-
-    // 1. 读取文件内容到 buffer
-    std::ifstream in(file_path, std::ios::binary | std::ios::in);
-    ASSERT(in.is_open());
-
-    in.seekg(0, std::ios::end);
-    size_t fileSize = in.tellg();
-    in.seekg(0, std::ios::beg);
-
-    std::vector<uint8_t> buffer(fileSize);
-    in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(fileSize));
-    in.close();
-
-    // 2. 执行反序列化
-    Storage_File back{};
-    auto result = infra::binary_serialization::deserialize(buffer, back);
-
-    ASSERT(result.code == infra::binary_serialization::ResultCode::OK);
-
-    // 3. 字段验证
+    // 字段验证
 
     // --- Bool & Bool Arrays ---
     ASSERT(back.flag1 == true);
@@ -2116,6 +4519,47 @@ void deserialize_from_file_test()
     ASSERT(back.char32_arr[1] == U'！');
 }
 
+void deserialize_from_file_test()
+{
+    // write_to_file();
+
+    namespace fs = std::filesystem;
+    fs::path file_path = fs::path(INFRA_TEST_EXE_DIR) / "test_file.bin";
+
+    // 1. 读取文件内容到 buffer
+    std::ifstream in(file_path, std::ios::binary | std::ios::in);
+    ASSERT(in.is_open());
+
+    in.seekg(0, std::ios::end);
+    size_t fileSize = in.tellg();
+    in.seekg(0, std::ios::beg);
+
+    std::vector<uint8_t> buffer(fileSize);
+    in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(fileSize));
+    in.close();
+
+    // 2. 执行反序列化
+    Storage_File back{};
+    auto result = infra::binary_serialization::deserialize(buffer, back);
+
+    ASSERT(result.code == infra::binary_serialization::ResultCode::OK);
+    verify_storage_file(back);
+
+    // 3. 直接从映射的文件反序列化
+    infra::binary_serialization::MappedFile mapped{};
+    ASSERT(mapped.open(file_path.string().c_str()));
+    ASSERT(mapped.size() == fileSize);
+
+    Storage_File mapped_back{};
+    result = infra::binary_serialization::deserialize(mapped, mapped_back);
+    ASSERT(result.code == infra::binary_serialization::ResultCode::OK);
+    verify_storage_file(mapped_back);
+
+    infra::binary_serialization::MappedFile missing{};
+    ASSERT(!missing.open((fs::path(INFRA_TEST_EXE_DIR) / "not_exist.bin").string().c_str()));
+    ASSERT(missing.size() == 0);
+}
+
 int main()
 {
     try
@@ -2130,6 +4574,25 @@ int main()
         error_test();
         user_abort_test();
         custom_structure_test();
+        bulk_values_test();
+        size_hint_test();
+        exact_size_test();
+        fixed_size_test();
+        memcpy_structure_test();
+        fused_checksum_test();
+        stream_sink_test();
+        mapped_file_writer_test();
+        span_test();
+        view_test();
+        length_prefix_test();
+        varint_test();
+        header_v2_test();
+        compression_test();
+        chunked_test();
+        indexed_table_test();
+        lazy_test();
+        framed_structure_test();
+        skip_frame_test();
         bool_test();
         deserialize_from_file_test();
     }